@@ -0,0 +1,66 @@
+// BakedModel.cpp
+#include "BakedModel.h"
+#include "BlockStateInterner.h"
+#include "BlockTraits.h"
+#include "MaterialRegistry.h"
+#include "blockstate.h"
+#include <algorithm>
+#include <random>
+
+BakedModelRegistry bakedModels;
+
+const ModelData& BakedModel::Select(const std::vector<uint32_t>** variantMaterials) const {
+    static const ModelData empty;
+    static const std::vector<uint32_t> noMaterials;
+    if (variants.empty()) {
+        if (variantMaterials) *variantMaterials = &noMaterials;
+        return empty;
+    }
+    if (variants.size() == 1) {
+        if (variantMaterials) *variantMaterials = &materialIds[0];
+        return variants[0];
+    }
+
+    // 与 GetRandomModelFromCache 相同的按权重抽取,只是改为在前缀和上二分查找
+    thread_local static std::mt19937 gen(std::random_device{}());
+    std::uniform_int_distribution<> dis(1, cumulativeWeights.back());
+    int randomWeight = dis(gen);
+    const size_t index = std::lower_bound(cumulativeWeights.begin(), cumulativeWeights.end(), randomWeight) - cumulativeWeights.begin();
+    if (variantMaterials) *variantMaterials = &materialIds[index];
+    return variants[index];
+}
+
+BakedModelRegistry::BakedModelRegistry()
+    : m_models(new std::atomic<const BakedModel*>[BlockStateInterner::kMaxStates]()) {
+}
+
+const BakedModel& BakedModelRegistry::Get(int blockId) {
+    static const BakedModel empty;
+    if (static_cast<unsigned>(blockId) >= BlockStateInterner::kMaxStates) {
+        return empty;
+    }
+
+    std::atomic<const BakedModel*>& slot = m_models[blockId];
+    const BakedModel* model = slot.load(std::memory_order_acquire);
+    if (model) {
+        return *model;
+    }
+
+    // 烘焙会把 multipart 的合并结果移出 blockstate 缓存,同一方块只能烘焙一次,因此在锁内串行烘焙
+    std::lock_guard<std::mutex> lock(m_ownedMutex);
+    model = slot.load(std::memory_order_acquire);
+    if (model) {
+        return *model;
+    }
+    auto baked = std::make_unique<BakedModel>(
+        BakeModelFromCache(blockTraits.ModelNamespace(blockId), blockTraits.ModelName(blockId)));
+    // 材质在烘焙时登记一次,网格生成直接使用全局材质ID
+    baked->materialIds.resize(baked->variants.size());
+    for (size_t i = 0; i < baked->variants.size(); ++i) {
+        materialRegistry.InternAll(baked->variants[i].materials, baked->materialIds[i]);
+    }
+    model = baked.get();
+    slot.store(model, std::memory_order_release);
+    m_owned.push_back(std::move(baked));
+    return *model;
+}
@@ -0,0 +1,49 @@
+// BakedModel.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "model.h"
+
+// 预烘焙的方块模型:一个方块状态的全部候选模型及其权重,创建后不再修改
+// 普通模型只有一个候选;variant 按权重随机;multipart 预先合并好每个随机位置的结果(等权重)
+struct BakedModel {
+    std::vector<ModelData> variants;
+    std::vector<int> cumulativeWeights; // 权重前缀和,与 variants 一一对应
+    std::vector<std::vector<uint32_t>> materialIds; // 各候选的局部材质索引 -> materialRegistry 中的ID
+    bool hasUncullableFaces = false;    // 任一候选含有 DO_NOT_CULL 面
+
+    // 按权重随机选择一个候选,没有模型时返回空模型
+    // variantMaterials 不为空时写入该候选的全局材质ID表(没有模型时为空表)
+    const ModelData& Select(const std::vector<uint32_t>** variantMaterials = nullptr) const;
+};
+
+// 按全局方块ID索引的烘焙模型表
+// 方块状态加入全局调色板时从 blockstate 模型缓存烘焙(未烘焙的ID在首次查询时补上),之后无锁返回同一个不可变对象的引用,
+// 网格生成不再按字符串查找模型缓存,也不再为每个方块复制整个 ModelData。
+class BakedModelRegistry {
+public:
+    BakedModelRegistry();
+
+    // 获取方块的烘焙模型;引用在程序运行期间一直有效
+    const BakedModel& Get(int blockId);
+
+    // 等价于 GetRandomModelFromCache,但返回引用
+    const ModelData& Select(int blockId) { return Get(blockId).Select(); }
+
+private:
+    BakedModelRegistry(const BakedModelRegistry&) = delete;
+    BakedModelRegistry& operator=(const BakedModelRegistry&) = delete;
+
+    std::unique_ptr<std::atomic<const BakedModel*>[]> m_models;
+
+    // 持有所有烘焙结果;烘焙也在此锁内进行
+    std::mutex m_ownedMutex;
+    std::vector<std::unique_ptr<BakedModel>> m_owned;
+};
+
+// 全局烘焙模型表
+extern BakedModelRegistry bakedModels;
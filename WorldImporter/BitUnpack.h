@@ -0,0 +1,144 @@
+// BitUnpack.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <cstdlib>  // _byteswap_uint64
+#endif
+
+// 调色板容器(block_states / biomes / Heightmaps)的位解包
+// 数据为大端 long 数组,每个 long 从低位开始存放 64/bits 个条目,条目不跨 long。
+// 每种位宽(1-16)都有编译期特化的内核,直接写入最终的类型化数组,可选经过查找表映射。
+namespace BitUnpack {
+
+    // 不做映射,输出调色板索引
+    struct Identity {};
+
+    // 通过查找表把调色板索引映射为最终值;表长度必须不小于 (1 << bits),超出调色板的部分由调用方填充
+    template <typename T>
+    struct Lut {
+        const T* table;
+    };
+
+    // 读取一个大端 long
+    inline uint64_t LoadBE64(const char* p) {
+        uint64_t v;
+        std::memcpy(&v, p, sizeof(v));
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_bswap64(v);
+#elif defined(_MSC_VER)
+        return _byteswap_uint64(v);
+#else
+        return ((v & 0xFF00000000000000ull) >> 56) | ((v & 0x00FF000000000000ull) >> 40) |
+            ((v & 0x0000FF0000000000ull) >> 24) | ((v & 0x000000FF00000000ull) >> 8) |
+            ((v & 0x00000000FF000000ull) << 8) | ((v & 0x0000000000FF0000ull) << 24) |
+            ((v & 0x000000000000FF00ull) << 40) | ((v & 0x00000000000000FFull) << 56);
+#endif
+    }
+
+    template <typename Out, typename Map>
+    inline Out Apply(const Map& map, uint32_t index) {
+        if constexpr (std::is_same_v<Map, Identity>) {
+            return static_cast<Out>(index);
+        } else {
+            return static_cast<Out>(map.table[index]);
+        }
+    }
+
+    // 运行期位宽的通用实现(>16 位时使用)
+    template <typename Out, typename Map>
+    size_t UnpackGeneric(const char* src, size_t numLongs, int bits, size_t count, Out* out, const Map& map) {
+        const int perLong = 64 / bits;
+        const uint64_t mask = (bits >= 64) ? ~0ull : ((1ull << bits) - 1);
+        size_t i = 0;
+        for (size_t l = 0; l < numLongs && i < count; ++l) {
+            uint64_t v = LoadBE64(src + l * 8);
+            for (int k = 0; k < perLong && i < count; ++k, ++i) {
+                out[i] = Apply<Out>(map, static_cast<uint32_t>((v >> (k * bits)) & mask));
+            }
+        }
+        return i;
+    }
+
+    // 标量内核:位宽为编译期常量,内层循环可完全展开
+    template <int Bits, typename Out, typename Map>
+    size_t UnpackScalar(const char* src, size_t numLongs, size_t count, Out* out, const Map& map) {
+        constexpr int kPerLong = 64 / Bits;
+        constexpr uint64_t kMask = (1ull << Bits) - 1;
+        size_t i = 0;
+        size_t l = 0;
+        // 完整的 long
+        for (; l < numLongs && i + kPerLong <= count; ++l, i += kPerLong) {
+            uint64_t v = LoadBE64(src + l * 8);
+            for (int k = 0; k < kPerLong; ++k) {
+                out[i + k] = Apply<Out>(map, static_cast<uint32_t>((v >> (k * Bits)) & kMask));
+            }
+        }
+        // 末尾不足一个 long 的部分
+        if (l < numLongs && i < count) {
+            uint64_t v = LoadBE64(src + l * 8);
+            for (int k = 0; i < count; ++k, ++i) {
+                out[i] = Apply<Out>(map, static_cast<uint32_t>((v >> (k * Bits)) & kMask));
+            }
+        }
+        return i;
+    }
+
+    /**
+     * 解包一个大端 long 数组
+     * @param data   原始负载(LONG_ARRAY 的字节)
+     * @param bits   每个条目的位数
+     * @param count  需要的条目数
+     * @param out    输出数组(至少 count 个元素)
+     * @param map    Identity 或 Lut
+     * @return 实际写入的条目数(数据不足时小于 count,其余元素保持不变)
+     */
+    template <typename Out, typename Map = Identity>
+    size_t Unpack(std::span<const char> data, int bits, size_t count, Out* out, const Map& map = Map{}) {
+        const char* src = data.data();
+        size_t numLongs = data.size() / 8;
+        if (bits <= 0 || numLongs == 0) return 0;
+        switch (bits) {
+        case 1:  return UnpackScalar<1>(src, numLongs, count, out, map);
+        case 2:  return UnpackScalar<2>(src, numLongs, count, out, map);
+        case 3:  return UnpackScalar<3>(src, numLongs, count, out, map);
+        case 4:  return UnpackScalar<4>(src, numLongs, count, out, map);
+        case 5:  return UnpackScalar<5>(src, numLongs, count, out, map);
+        case 6:  return UnpackScalar<6>(src, numLongs, count, out, map);
+        case 7:  return UnpackScalar<7>(src, numLongs, count, out, map);
+        case 8:  return UnpackScalar<8>(src, numLongs, count, out, map);
+        case 9:  return UnpackScalar<9>(src, numLongs, count, out, map);
+        case 10: return UnpackScalar<10>(src, numLongs, count, out, map);
+        case 11: return UnpackScalar<11>(src, numLongs, count, out, map);
+        case 12: return UnpackScalar<12>(src, numLongs, count, out, map);
+        case 13: return UnpackScalar<13>(src, numLongs, count, out, map);
+        case 14: return UnpackScalar<14>(src, numLongs, count, out, map);
+        case 15: return UnpackScalar<15>(src, numLongs, count, out, map);
+        case 16: return UnpackScalar<16>(src, numLongs, count, out, map);
+        default: return UnpackGeneric(src, numLongs, bits, count, out, map);
+        }
+    }
+
+    // 向上取整的 log2,n <= 1 时返回 0
+    inline int CeilLog2(size_t n) {
+        int bits = 0;
+        while ((size_t(1) << bits) < n) ++bits;
+        return bits;
+    }
+
+    // block_states 的位宽:至少 4 位
+    inline int BlockStateBits(size_t paletteSize) {
+        int bits = CeilLog2(paletteSize);
+        return bits < 4 ? 4 : bits;
+    }
+
+    // biomes 的位宽:ceil(log2 n),单一调色板时为 0(没有 data 数组)
+    inline int BiomeBits(size_t paletteSize) {
+        return CeilLog2(paletteSize);
+    }
+}
@@ -0,0 +1,18 @@
+// BlockStateInterner.cpp
+#include "BlockStateInterner.h"
+#include "block.h"
+#include <iostream>
+
+BlockStateInterner blockStateInterner;
+
+uint32_t BlockStateInterner::Intern(const std::string& name, bool* isNew) {
+    // 特性表在新ID对其他线程可见之前登记
+    std::optional<uint32_t> id = m_states.Intern(name, isNew,
+        [](uint32_t newId, const Block& block) { blockTraits.Register(static_cast<int>(newId), block); },
+        name);
+    if (!id) {
+        std::cerr << "全局方块调色板已满,按空气处理: " << name << std::endl;
+        return 0;
+    }
+    return *id;
+}
@@ -0,0 +1,34 @@
+// BlockStateInterner.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "ShardedInterner.h"
+
+struct Block;
+
+// 全局方块调色板:方块状态名 -> 稳定的全局ID
+// 查找与存储由 ShardedInterner 完成:按名称分片加读写锁,已存在的状态只需分片的共享锁;
+// 方块对象存放在只追加的分块数组中,新增状态不会搬移已有对象,按ID读取无需加锁。
+class BlockStateInterner {
+public:
+    // 子区块中的方块ID为 16 位,ID 上限与之一致
+    static constexpr size_t kMaxStates = 65536;
+
+    // 返回状态名对应的ID,不存在时新建(同时登记 blockTraits)
+    // isNew 不为空时写入本次调用是否新建了该状态;超过上限时返回 0(空气)
+    uint32_t Intern(const std::string& name, bool* isNew = nullptr);
+
+    // 按ID读取方块;ID 必须来自 Intern(或随子区块发布),否则返回 nullptr
+    const Block* Find(uint32_t id) const { return m_states.Find(id); }
+
+    // 已登记的状态数,ID 为 [0, Size())
+    size_t Size() const { return m_states.Size(); }
+
+private:
+    ShardedInterner<Block, kMaxStates> m_states;
+};
+
+// 全局方块调色板
+extern BlockStateInterner blockStateInterner;
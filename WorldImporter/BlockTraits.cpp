@@ -0,0 +1,135 @@
+// BlockTraits.cpp
+#include "BlockTraits.h"
+#include "block.h"
+#include "fluid.h"
+#include "GlobalCache.h"
+#include "config.h"
+#include <algorithm>
+#include <iostream>
+
+extern Config config;
+
+BlockTraitsTable blockTraits;
+
+namespace {
+    // 名称的状态部分中是否有 key:value(状态格式为 [k1:v1,k2:v2])
+    bool HasStateValue(const std::string& name, const std::string& key, const std::string& value) {
+        size_t bracketPos = name.find('[');
+        if (bracketPos == std::string::npos || key.empty()) {
+            return false;
+        }
+        const std::string needle = key + ":" + value;
+        size_t pos = name.find(needle, bracketPos + 1);
+        while (pos != std::string::npos) {
+            char before = name[pos - 1];
+            size_t endPos = pos + needle.size();
+            char after = endPos < name.size() ? name[endPos] : ']';
+            if ((before == '[' || before == ',') && (after == ',' || after == ']')) {
+                return true;
+            }
+            pos = name.find(needle, pos + 1);
+        }
+        return false;
+    }
+}
+
+BlockTraitsTable::BlockTraitsTable()
+    : m_flags(new uint8_t[kMaxBlockStates]),
+      m_level(new int8_t[kMaxBlockStates]),
+      m_fluidId(new uint16_t[kMaxBlockStates]),
+      m_baseNameId(new uint32_t[kMaxBlockStates]),
+      m_modelKeyId(new uint32_t[kMaxBlockStates]),
+      m_names(new std::unique_ptr<StateNames>[kMaxBlockStates]) {
+    for (size_t i = 0; i < kMaxBlockStates; ++i) {
+        m_flags[i] = kAir;
+        m_level[i] = -1;
+        m_fluidId[i] = kNoFluid;
+        m_baseNameId[i] = 0;
+        m_modelKeyId[i] = 0;
+    }
+    // 流体种类很少,预留后登记时不会搬移
+    m_fluidNames.reserve(256);
+}
+
+void BlockTraitsTable::Register(int id, const Block& block) {
+    if (!InRange(id)) {
+        std::cerr << "方块状态数量超过上限 " << kMaxBlockStates << ": " << block.name << std::endl;
+        return;
+    }
+
+    auto names = std::make_unique<StateNames>();
+    names->name = block.name;
+    names->baseName = block.GetNameAndNameSpaceWithoutState();
+
+    // 模型键与 ChunkGenerator 之前每个方块现算的结果一致
+    std::string modifiedName = block.GetModifiedNameWithNamespace();
+    names->modelNamespace = block.GetNamespace();
+    size_t colonPos = modifiedName.find(':');
+    names->modelName = (colonPos != std::string::npos) ? modifiedName.substr(colonPos + 1) : modifiedName;
+
+    uint8_t flags = 0;
+    if (modifiedName == "minecraft:air") {
+        flags |= kAir;
+    }
+    if (!block.air) {
+        flags |= kSolid;
+    }
+    if (config.lod1Blocks.count(names->baseName)) {
+        flags |= kLod1;
+    }
+    size_t pathPos = names->baseName.find(':');
+    if (names->baseName.compare(pathPos == std::string::npos ? 0 : pathPos + 1, std::string::npos, "light") == 0) {
+        flags |= kLightBlock;
+    }
+
+    // 流体:方块本身是流体,或通过 liquid_blocks / 属性(如 waterlogged)含有流体
+    std::string fluidName;
+    if (fluidDefinitions.count(names->baseName)) {
+        flags |= kFluid;
+        fluidName = names->baseName;
+    }
+    else if (block.level == 0) {
+        for (const auto& fluidEntry : fluidDefinitions) {
+            const FluidInfo& info = fluidEntry.second;
+            if (info.liquid_blocks.count(names->baseName) || HasStateValue(block.name, info.property, "true")) {
+                fluidName = fluidEntry.first;
+                break;
+            }
+        }
+        flags |= kWaterlogged;
+    }
+
+    uint16_t fluidId = kNoFluid;
+    if (!fluidName.empty()) {
+        auto it = std::find(m_fluidNames.begin(), m_fluidNames.end(), fluidName);
+        fluidId = static_cast<uint16_t>(it - m_fluidNames.begin());
+        if (it == m_fluidNames.end()) {
+            m_fluidNames.push_back(fluidName);
+        }
+    }
+
+    m_flags[id] = flags;
+    m_level[id] = block.level;
+    m_fluidId[id] = fluidId;
+    m_baseNameId[id] = Intern(m_baseNameIds, names->baseName);
+    m_modelKeyId[id] = Intern(m_modelKeyIds, modifiedName);
+    m_names[id] = std::move(names);
+}
+
+const std::string& BlockTraitsTable::FluidName(uint16_t fluidId) const {
+    static const std::string empty;
+    return fluidId < m_fluidNames.size() ? m_fluidNames[fluidId] : empty;
+}
+
+const BlockTraitsTable::StateNames& BlockTraitsTable::Names(int id) const {
+    static const StateNames air{ "minecraft:air", "minecraft:air", "minecraft", "air" };
+    if (!InRange(id) || !m_names[id]) {
+        return air;
+    }
+    return *m_names[id];
+}
+
+uint32_t BlockTraitsTable::Intern(std::unordered_map<std::string, uint32_t>& ids, const std::string& key) {
+    auto result = ids.emplace(key, static_cast<uint32_t>(ids.size()));
+    return result.first->second;
+}
@@ -0,0 +1,95 @@
+// BlockTraits.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct Block;
+
+// 按全局方块ID索引的方块属性表(结构数组)
+// 每个方块状态在加入全局调色板时解析一次名称,网格生成与 LOD 的热路径只读取这里的整数和标志,
+// 不再拷贝 Block 或反复解析方块名。全局ID为 16 位,数组一次分配到最大容量,登记新方块时不会搬移,
+// 因此读线程可以与加载线程同时访问(方块ID总是先登记、再随子区块发布)。
+class BlockTraitsTable {
+public:
+    static constexpr size_t kMaxBlockStates = 65536;
+    static constexpr uint16_t kNoFluid = 0xFFFF;
+
+    BlockTraitsTable();
+
+    // 登记一个新的全局方块ID(由 BlockStateInterner 在新增状态时串行调用,id 按顺序递增)
+    void Register(int id, const Block& block);
+
+    // 方块为 minecraft:air
+    bool IsAir(int id) const { return (Flags(id) & kAir) != 0; }
+    // 在 solids 列表中:会遮挡相邻方块的面
+    bool IsSolid(int id) const { return (Flags(id) & kSolid) != 0; }
+    // 方块本身是注册的流体(如 minecraft:water)
+    bool IsFluid(int id) const { return (Flags(id) & kFluid) != 0; }
+    // 含水方块(waterlogged 属性或强制含水的方块),不包括流体本身
+    bool IsWaterlogged(int id) const { return (Flags(id) & kWaterlogged) != 0; }
+    // 在 LOD 中使用原始模型(config.lod1Blocks)
+    bool IsLod1(int id) const { return (Flags(id) & kLod1) != 0; }
+    // 光源方块(minecraft:light 等),exportLightBlockOnly 时只导出这些方块
+    bool IsLightBlock(int id) const { return (Flags(id) & kLightBlock) != 0; }
+
+    // 流体等级:-1 表示不含流体,含水方块为 0
+    int Level(int id) const { return InRange(id) ? m_level[id] : -1; }
+    // 所含流体的编号(流体本身或含水方块中的流体),没有时为 kNoFluid
+    uint16_t FluidId(int id) const { return InRange(id) ? m_fluidId[id] : kNoFluid; }
+    // 不带状态的方块名编号,同名不同状态的方块编号相同
+    uint32_t BaseNameId(int id) const { return InRange(id) ? m_baseNameId[id] : 0; }
+    // 模型键编号(去掉 distance/persistent 后的名称),状态只差这些属性的方块共享模型
+    uint32_t ModelKeyId(int id) const { return InRange(id) ? m_modelKeyId[id] : 0; }
+
+    // 冷数据:名称字符串,仅在生成模型或材质时使用
+    const std::string& Name(int id) const { return Names(id).name; }
+    const std::string& BaseName(int id) const { return Names(id).baseName; }
+    const std::string& ModelNamespace(int id) const { return Names(id).modelNamespace; }
+    const std::string& ModelName(int id) const { return Names(id).modelName; }
+    const std::string& FluidName(uint16_t fluidId) const;
+
+private:
+    enum : uint8_t {
+        kAir = 1 << 0,
+        kSolid = 1 << 1,
+        kFluid = 1 << 2,
+        kWaterlogged = 1 << 3,
+        kLod1 = 1 << 4,
+        kLightBlock = 1 << 5,
+    };
+
+    struct StateNames {
+        std::string name;           // 完整名称,如 minecraft:oak_stairs[facing:east,...]
+        std::string baseName;       // 命名空间:方块名,不带状态
+        std::string modelNamespace; // 模型缓存的命名空间
+        std::string modelName;      // 模型缓存的方块名(不带命名空间,状态使用 = 分隔)
+    };
+
+    static bool InRange(int id) { return static_cast<unsigned>(id) < kMaxBlockStates; }
+
+    // 未登记的ID按空气处理,与 GetBlockById 越界时一致
+    uint8_t Flags(int id) const { return InRange(id) ? m_flags[id] : static_cast<uint8_t>(kAir); }
+    const StateNames& Names(int id) const;
+
+    uint32_t Intern(std::unordered_map<std::string, uint32_t>& ids, const std::string& key);
+
+    std::unique_ptr<uint8_t[]> m_flags;
+    std::unique_ptr<int8_t[]> m_level;
+    std::unique_ptr<uint16_t[]> m_fluidId;
+    std::unique_ptr<uint32_t[]> m_baseNameId;
+    std::unique_ptr<uint32_t[]> m_modelKeyId;
+    std::unique_ptr<std::unique_ptr<StateNames>[]> m_names;
+
+    // 以下只在登记时访问(登记是串行的)
+    std::unordered_map<std::string, uint32_t> m_baseNameIds;
+    std::unordered_map<std::string, uint32_t> m_modelKeyIds;
+    std::vector<std::string> m_fluidNames;
+};
+
+// 全局方块属性表
+extern BlockTraitsTable blockTraits;
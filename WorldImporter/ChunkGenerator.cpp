@@ -9,6 +9,9 @@
 #include "fluid.h"
 #include "LODManager.h"
 #include "texture.h"
+#include "blockstate.h"
+#include "BakedModel.h"
+#include "FluidSurfaceMesher.h"
 #include <iomanip>
 #include <sstream>
 #include <regex>
@@ -18,6 +21,8 @@
 #include <iostream>
 #include <thread>
 #include <atomic>
+#include <bit>
+#include <memory>
 #include "ModelDeduplicator.h"
 #include "ChunkGroupAllocator.h"
 #include <utility>
@@ -26,80 +31,180 @@
 using namespace std;
 using namespace std::chrono;
 
-std::unordered_set<std::pair<int, int>, pair_hash> processedChunks;
-std::mutex entityCacheMutex; // 互斥量,确保线程安全
-static const std::unordered_map<FaceType, int> neighborIndexMap = {
-        {FaceType::DOWN, 1}, {FaceType::UP, 0}, {FaceType::NORTH, 4},
-        {FaceType::SOUTH, 5}, {FaceType::WEST, 2}, {FaceType::EAST, 3}
-};
-void ChunkGenerator::ProcessBlockForModel(ModelData& chunkModel, int x, int y, int z) {
-    std::array<bool, 6> neighbors; // 邻居是否为空气
-    std::array<int, 10> fluidLevels; // 流体液位
+// 面方向 -> neighbors 下标(UP, DOWN, NORTH, SOUTH, WEST, EAST),其余方向返回 -1
+static int NeighborIndex(FaceType dir) {
+    static const int kNeighborIndex[] = {
+        SectionFaceMasks::kUp, SectionFaceMasks::kDown, SectionFaceMasks::kNorth,
+        SectionFaceMasks::kSouth, SectionFaceMasks::kWest, SectionFaceMasks::kEast
+    };
+    return (dir >= FaceType::UP && dir <= FaceType::EAST) ? kNeighborIndex[dir] : -1;
+}
 
-    int id = GetBlockIdWithNeighbors(x, y, z, neighbors.data(), fluidLevels.data());
-    Block currentBlock = GetBlockById(id);
-    string blockName = currentBlock.GetModifiedNameWithNamespace();
-    if (blockName == "minecraft:air") return;
+// 子区块中是否有模型含 DO_NOT_CULL 面的方块(即使被包围也要输出)
+// 在网格生成阶段查询:加载期间新方块状态的模型可能仍在其他线程中生成,不能提前烘焙
+static bool SectionHasUncullableFaces(const SectionCacheEntry& section) {
+    if (section.IsUniform()) {
+        return bakedModels.Get(section.uniformBlock).hasUncullableFaces;
+    }
+    // 标记数组按线程复用,用完按 distinct 清回
+    thread_local std::vector<bool> seen(BlockTraitsTable::kMaxBlockStates, false);
+    thread_local std::vector<uint16_t> distinct;
+    distinct.clear();
+    for (uint16_t id : section.blockData) {
+        if (!seen[id]) {
+            seen[id] = true;
+            distinct.push_back(id);
+        }
+    }
+    bool result = false;
+    for (uint16_t id : distinct) {
+        seen[id] = false;
+        result = result || bakedModels.Get(id).hasUncullableFaces;
+    }
+    return result;
+}
 
-    if (config.exportLightBlockOnly)
-    {
-        string processed = blockName;
+bool ChunkGenerator::SectionMayHaveVisibleBlocks(int chunkX, int sectionY, int chunkZ) {
+    const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
+    if (!section) return false; // 缺失的子区块按空气处理
+    const SectionSummary& summary = section->summary;
+    if (summary.nonAirCount == 0) return false;
+    if (summary.solidCount != 4096 || summary.hasFluid) return true;
+
+    // 保留边界面时导出区域外一格不遮挡(与 BuildFaceMasks 相同),快照范围碰到这一格就不能跳过
+    if (config.keepBoundary) {
+        const int x0 = chunkX * 16 - 1, x1 = chunkX * 16 + 16;
+        const int z0 = chunkZ * 16 - 1, z1 = chunkZ * 16 + 16;
+        auto inRange = [](int v, int lo, int hi) { return v >= lo && v <= hi; };
+        if (inRange(config.minX - 1, x0, x1) || inRange(config.maxX + 1, x0, x1) ||
+            inRange(config.minZ - 1, z0, z1) || inRange(config.maxZ + 1, z0, z1)) {
+            return true;
+        }
+    }
 
-        // 提取命名空间
-        size_t colonPos = processed.find(':');
-        string ns = "minecraft"; // 默认命名空间
-        if (colonPos != string::npos) {
-            ns = processed.substr(0, colonPos);
-            processed = processed.substr(colonPos + 1);
+    // 整个子区块都是 solids:只有外层可能露出,检查六个相邻子区块朝向本子区块的外层
+    static const int kOffsets[SectionFaceMasks::kDirectionCount][3] = {
+        {0, 1, 0}, {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, 0, -1}, {0, 0, 1}
+    };
+    for (int dir = 0; dir < SectionFaceMasks::kDirectionCount; ++dir) {
+        const SectionCacheEntry* neighbor = sectionGrid.FindSection(
+            chunkX + kOffsets[dir][0], sectionY + kOffsets[dir][1], chunkZ + kOffsets[dir][2]);
+        const int opposite = dir ^ 1; // 上/下、西/东、北/南 两两相邻
+        if (!neighbor || !((neighbor->summary.solidShell >> opposite) & 1)) {
+            return true;
         }
+    }
+    // 完全被包围时只有 DO_NOT_CULL 面可能输出
+    return SectionHasUncullableFaces(*section);
+}
 
-        // 提取方块ID和状态
-        size_t bracketPos = processed.find('[');
-        string LN = processed.substr(0, bracketPos);
+bool ChunkGenerator::MayEmitGeometry(int chunkX, int sectionY, int chunkZ, float lodSize) {
+    const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
+    if (!section) return false;
+    // 实体方块由 EntityMesher 按任务所在的组输出,含实体方块的子区块总是保留
+    // (实体方块在导出范围外的区块由调用方另外保留一个任务)
+    if (section->summary.hasEntityBlocks) return true;
+    if (lodSize > 0.0f) {
+        // LOD 方块不超过子区块时只读取本子区块(及上方一层用于判断液面),全空气不会生成方块
+        return section->summary.nonAirCount > 0 || lodSize > 16.0f;
+    }
+    return SectionMayHaveVisibleBlocks(chunkX, sectionY, chunkZ);
+}
+
+void ChunkGenerator::ProcessSectionBlocks(MeshBuilder& builder, const SectionSnapshot& snapshot, const SectionFaceMasks& masks,
+    int lxBegin, int lxEnd, int lyBegin, int lyEnd, int lzBegin, int lzEnd) {
+    if (lyBegin > lyEnd) return;
+    const uint16_t yRange = static_cast<uint16_t>(((1u << (lyEnd + 1)) - 1) & ~((1u << lyBegin) - 1));
+
+    // 顶面平坦的纯流体按整个子区块生成(顶面合并),其余含流体的方块仍逐方块处理
+    std::array<uint16_t, 256> fluidHandled;
+    FluidSurfaceMesher::MeshSection(builder, snapshot, masks, lxBegin, lxEnd, lyBegin, lyEnd, lzBegin, lzEnd, fluidHandled);
+
+    // 与之前逐方块遍历的顺序相同(x, z, y),只是跳过被完全遮挡的方块
+    for (int lx = lxBegin; lx <= lxEnd; ++lx) {
+        for (int lz = lzBegin; lz <= lzEnd; ++lz) {
+            const int column = SectionFaceMasks::Column(lx, lz);
+            uint16_t anyVisible = 0;
+            for (int dir = 0; dir < SectionFaceMasks::kDirectionCount; ++dir) {
+                anyVisible |= masks.visible[dir][column];
+            }
+            const uint16_t candidates = masks.nonAir[column] & yRange & ~fluidHandled[column];
+            // 含流体的方块剔除规则不同,总是交给逐方块处理
+            uint16_t emit = candidates & (anyVisible | masks.fluid[column]);
+            // 四周都被遮挡的方块只有模型含 DO_NOT_CULL 面时才需要输出
+            uint16_t buried = candidates & ~emit;
+            while (buried) {
+                const int ly = std::countr_zero(buried);
+                buried &= buried - 1;
+                if (bakedModels.Get(snapshot.BlockId(lx, ly, lz)).hasUncullableFaces) {
+                    emit |= static_cast<uint16_t>(1u << ly);
+                }
+            }
 
+            while (emit) {
+                const int ly = std::countr_zero(emit);
+                emit &= emit - 1;
+                ProcessBlockForModel(builder, snapshot, masks, lx, ly, lz);
+            }
+        }
+    }
+}
 
-        if (LN != "light") {
-            return;
+void ChunkGenerator::ProcessBlockForModel(MeshBuilder& builder, const SectionSnapshot& snapshot, const SectionFaceMasks& masks,
+    int lx, int ly, int lz) {
+    std::array<bool, 6> neighbors; // 邻居是否为空气
+    std::array<int, 10> fluidLevels; // 流体液位
+    const int x = snapshot.OriginX() + lx;
+    const int y = snapshot.OriginY() + ly;
+    const int z = snapshot.OriginZ() + lz;
+
+    int id;
+    const int column = SectionFaceMasks::Column(lx, lz);
+    if ((masks.fluid[column] >> ly) & 1) {
+        id = snapshot.BlockIdWithNeighbors(lx, ly, lz, neighbors.data(), fluidLevels.data());
+    }
+    else {
+        // 不含流体的方块直接取可见性掩码
+        id = snapshot.BlockId(lx, ly, lz);
+        for (int dir = 0; dir < SectionFaceMasks::kDirectionCount; ++dir) {
+            neighbors[dir] = (masks.visible[dir][column] >> ly) & 1;
         }
     }
-    if (config.cullCave)
+    if (blockTraits.IsAir(id)) return;
+
+    if (config.exportLightBlockOnly && !blockTraits.IsLightBlock(id))
     {
-        if (GetSkyLight(x, y, z) == -1) return;
+        return;
     }
-
-    string ns = currentBlock.GetNamespace();
-
-    // 标准化方块名称(去掉命名空间,处理状态)
-    size_t colonPos = blockName.find(':');
-    if (colonPos != string::npos) {
-        blockName = blockName.substr(colonPos + 1);
+    if (config.cullCave)
+    {
+        if (snapshot.SkyLight(lx, ly, lz) == -1) return;
     }
 
-    ModelData blockModel;
-    ModelData liquidModel;
-    if (currentBlock.level > -1) {
-        blockModel = GetRandomModelFromCache(ns, blockName);
-
-        if (blockModel.vertices.empty()) {
-            liquidModel = GenerateFluidModel(fluidLevels, currentBlock.name);
-            AssignFluidMaterials(liquidModel, currentBlock.name);
-            blockModel = liquidModel;
+    // 烘焙模型与流体模型都只读共享,含水方块才需要复制一份来合并
+    // 材质已在烘焙时登记为全局ID;与流体合并后的模型材质表不同,追加时再按名称登记
+    const std::vector<uint32_t>* materialIds = nullptr;
+    const ModelData* sourceModel = &bakedModels.Get(id).Select(&materialIds);
+    ModelData mergedModel;
+    if (blockTraits.Level(id) > -1) {
+        const FluidModel& liquid = fluidModels.Get(fluidLevels, blockTraits.FluidId(id));
+
+        if (sourceModel->vertices.empty()) {
+            sourceModel = &liquid.model;
+            materialIds = &liquid.materialIds;
         }
         else
         {
-            liquidModel = GenerateFluidModel(fluidLevels, currentBlock.name);
-            AssignFluidMaterials(liquidModel, currentBlock.name);
+            ModelData blockModel = *sourceModel;
 
             // 只对有流体方向的面设置为不剔除
             for (auto& face : blockModel.faces)
             {
                 FaceType dir = face.faceDirection;
                 if (dir != FaceType::DO_NOT_CULL) {
-                    auto it = neighborIndexMap.find(dir);
-                    if (it != neighborIndexMap.end()) {
-                        int neighborIdx = it->second;
+                    if (NeighborIndex(dir) >= 0) {
                         // 检查相邻方向是否有流体
-                        int nx = x, ny = y, nz = z;
+                        int nx = lx, ny = ly, nz = lz;
                         if (dir == FaceType::DOWN) ny--;
                         else if (dir == FaceType::UP) ny++;
                         else if (dir == FaceType::NORTH) nz--;
@@ -107,24 +212,21 @@ void ChunkGenerator::ProcessBlockForModel(ModelData& chunkModel, int x, int y, i
                         else if (dir == FaceType::WEST) nx--;
                         else if (dir == FaceType::EAST) nx++;
                         
-                        int neighborId = GetBlockId(nx, ny, nz);
-                        Block neighborBlock = GetBlockById(neighborId);
+                        int neighborId = snapshot.BlockId(nx, ny, nz);
                         // 如果邻居是流体或含有流体，则不剔除
-                        if (neighborBlock.level > -1) {
+                        if (blockTraits.Level(neighborId) > -1) {
                             face.faceDirection = FaceType::DO_NOT_CULL;
                         }
                     }
                 }
             }
 
-            blockModel = MergeFluidModelData(blockModel, liquidModel);
+            mergedModel = MergeFluidModelData(blockModel, liquid.model);
+            sourceModel = &mergedModel;
+            materialIds = nullptr;
         }
     }
-    else
-    {
-        // 处理其他方块
-        blockModel = GetRandomModelFromCache(ns, blockName);
-    }
+    const ModelData& blockModel = *sourceModel;
 
     if (blockModel.vertices.empty()) return;
 
@@ -145,48 +247,20 @@ void ChunkGenerator::ProcessBlockForModel(ModelData& chunkModel, int x, int y, i
             validFaceIndices.push_back(faceIdx);
         }
         else {
-            auto it = neighborIndexMap.find(dir);
-            if (it != neighborIndexMap.end()) {
-                int neighborIdx = it->second;
-                if (!neighbors[neighborIdx]) { // 如果邻居存在(非空气),跳过该面
-                    continue;
-                }
+            int neighborIdx = NeighborIndex(dir);
+            if (neighborIdx >= 0 && !neighbors[neighborIdx]) { // 如果邻居存在(非空气),跳过该面
+                continue;
             }
             validFaceIndices.push_back(faceIdx);
         }
     }
 
-    // 重建面数据(使用新的Face结构体)
-    ModelData filteredModel;
-    filteredModel.faces.reserve(validFaceIndices.size());
-
-    for (int faceIdx : validFaceIndices) {
-        // 直接复制Face结构体
-        filteredModel.faces.push_back(blockModel.faces[faceIdx]);
-    }
-
-    // 顶点和UV数据保持不变(后续合并时会去重)
-    filteredModel.vertices = blockModel.vertices;
-    filteredModel.uvCoordinates = blockModel.uvCoordinates;
-    filteredModel.materials = blockModel.materials;
-
-    // 使用过滤后的模型
-    blockModel = std::move(filteredModel);
-
-    ApplyPositionOffset(blockModel, x, y, z);
-
-    // 合并到主模型
-    if (chunkModel.vertices.empty()) {
-        chunkModel = blockModel;
-    }
-    else {
-        MergeModelsDirectly(chunkModel, blockModel);
-    }
+    // 只把保留的面追加到构建器,顶点在复制时偏移到世界坐标
+    builder.AppendFaces(blockModel, validFaceIndices, x, y, z, materialIds);
 }
 
-ModelData ChunkGenerator::GenerateChunkModel(int chunkX, int sectionY, int chunkZ) {
+void ChunkGenerator::GenerateChunkModel(MeshBuilder& builder, int chunkX, int sectionY, int chunkZ) {
     // 从RegionModelExporter.cpp中复制GenerateChunkModel的实现
-    ModelData chunkModel;
     int xStart = config.minX;
     int xEnd = config.maxX;
     int yStart = config.minY;
@@ -200,55 +274,24 @@ ModelData ChunkGenerator::GenerateChunkModel(int chunkX, int sectionY, int chunk
     int blockYStart = sectionY * 16;
    
     
-    // 遍历区块内的每个方块
-    for (int x = blockXStart; x < blockXStart + 16; ++x) {
-        for (int z = blockZStart; z < blockZStart + 16; ++z) {
-            for (int y = blockYStart; y < blockYStart + 16; ++y) {
-                
-                // 检查当前方块是否在导出区域内
-                if (x < xStart || x > xEnd || y < yStart || y > yEnd || z < zStart || z > zEnd) {
-                    continue; // 跳过不在导出区域内的方块
-                }
-                ProcessBlockForModel(chunkModel, x, y, z);
-            }
-        }
+    // 全空气或被完全包围的子区块不需要逐方块处理
+    if (SectionMayHaveVisibleBlocks(chunkX, sectionY, chunkZ)) {
+        // 子区块与一格边界一次性复制到连续缓冲区,之后的邻居查询都在缓冲区内完成
+        SectionSnapshot snapshot;
+        snapshot.Fill(chunkX, sectionY, chunkZ);
+        SectionFaceMasks masks;
+        snapshot.BuildFaceMasks(masks);
+
+        // 只处理导出区域内的方块
+        ProcessSectionBlocks(builder, snapshot, masks,
+            (std::max)(xStart - blockXStart, 0), (std::min)(xEnd - blockXStart, 15),
+            (std::max)(yStart - blockYStart, 0), (std::min)(yEnd - blockYStart, 15),
+            (std::max)(zStart - blockZStart, 0), (std::min)(zEnd - blockZStart, 15));
     }
-
-    
-    auto chunkKey = std::make_pair(chunkX, chunkZ);
-    {
-        std::lock_guard<std::mutex> lock(entityCacheMutex);
-        if (processedChunks.find(chunkKey) != processedChunks.end()) {
-            return chunkModel;
-        }
-    }
-
-    if (EntityBlockCache.find(chunkKey) != EntityBlockCache.end()) {
-        const auto& entityBlocks = EntityBlockCache[chunkKey];
-        for (const auto& entity : entityBlocks) {
-            ModelData EntityModel;
-            if (entity != nullptr) {
-                EntityModel = entity->GenerateModel();
-                if (chunkModel.vertices.empty()) {
-                    chunkModel = EntityModel;
-                }
-                else {
-                    MergeModelsDirectly(chunkModel, EntityModel);
-                }
-            }
-        }
-    }
-
-    {
-        std::lock_guard<std::mutex> lock(entityCacheMutex);
-        processedChunks.insert(chunkKey);
-    }
-    return chunkModel;
 }
 
-ModelData ChunkGenerator::GenerateLODChunkModel(int chunkX, int sectionY, int chunkZ, float lodSize) {
+void ChunkGenerator::GenerateLODChunkModel(MeshBuilder& builder, int chunkX, int sectionY, int chunkZ, float lodSize) {
     // 从RegionModelExporter.cpp中复制GenerateLODChunkModel的实现
-    ModelData chunkModel;
     int xStart = config.minX;
     int xEnd = config.maxX;
     int yStart = config.minY;
@@ -262,6 +305,14 @@ ModelData ChunkGenerator::GenerateLODChunkModel(int chunkX, int sectionY, int ch
 
     int lodBlockSize = static_cast<int>(lodSize);
 
+    // LOD1 下 lod1Blocks 中的方块使用原始模型,需要邻居快照
+    SectionSnapshot snapshot;
+    SectionFaceMasks masks;
+    if (lodBlockSize == 1) {
+        snapshot.Fill(chunkX, sectionY, chunkZ);
+        snapshot.BuildFaceMasks(masks);
+    }
+
     for (int x = blockXStart; x < blockXStart + 16; x += lodBlockSize) {
         for (int z = blockZStart; z < blockZStart + 16; z += lodBlockSize) {
             for (int y = blockYStart; y < blockYStart + 16; y += lodBlockSize) {
@@ -281,12 +332,9 @@ ModelData ChunkGenerator::GenerateLODChunkModel(int chunkX, int sectionY, int ch
                 
                 // 检查是否应该使用原始模型
                 if (id != -1) {
-                    Block currentBlock = GetBlockById(id);
-                    std::string blockName = currentBlock.GetModifiedNameWithNamespace();
-                    
                     // 仅在LOD级别为1时启用原始模型功能
-                    if (lodBlockSize == 1 && LODManager::ShouldUseOriginalModel(blockName)) {
-                        ProcessBlockForModel(chunkModel, x, y, z);
+                    if (lodBlockSize == 1 && blockTraits.IsLod1(id)) {
+                        ProcessBlockForModel(builder, snapshot, masks, x - blockXStart, y - blockYStart, z - blockZStart);
                         continue; // 跳过LOD方块生成
                     }
                 }
@@ -295,16 +343,13 @@ ModelData ChunkGenerator::GenerateLODChunkModel(int chunkX, int sectionY, int ch
                 level = (lodBlockSize - (level));
                 // 如果块类型是固体
                 if (type == SOLID) {
-                    ModelData solidBox = LODManager::GenerateBox(x, y, z, lodBlockSize, level, color);
-                    MergeModelsDirectly(chunkModel, solidBox);
+                    builder.Append(LODManager::GenerateBox(x, y, z, lodBlockSize, level, color));
                 }
                 if (type ==FLUID)
                 {
-                    ModelData solidBox = LODManager::GenerateBox(x, y, z, lodBlockSize, level, color);
-                    MergeModelsDirectly(chunkModel, solidBox);
+                    builder.Append(LODManager::GenerateBox(x, y, z, lodBlockSize, level, color));
                 }
             }
         }
     }
-    return chunkModel;
 }
\ No newline at end of file
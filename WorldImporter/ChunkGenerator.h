@@ -4,13 +4,27 @@
 
 #include "model.h"
 #include "block.h"
+#include "SectionSnapshot.h"
+#include "MeshBuilder.h"
 
 class ChunkGenerator {
 public:
-    static ModelData GenerateChunkModel(int chunkX, int sectionY, int chunkZ);
-    static ModelData GenerateLODChunkModel(int chunkX, int sectionY, int chunkZ, float lodSize);
+    // 生成的几何体直接追加到 builder(通常是当前线程的 MeshBuilder::ForThread())
+    static void GenerateChunkModel(MeshBuilder& builder, int chunkX, int sectionY, int chunkZ);
+    static void GenerateLODChunkModel(MeshBuilder& builder, int chunkX, int sectionY, int chunkZ, float lodSize);
+
+    // 根据子区块摘要判断任务是否可能输出几何体,lodSize 为 0 表示完整模型;调用方需在 EpochGuard 作用域内
+    static bool MayEmitGeometry(int chunkX, int sectionY, int chunkZ, float lodSize);
 private:
-    static void ProcessBlockForModel(ModelData& chunkModel, int x, int y, int z);
+    // 子区块中的方块是否可能有可见面:全空气,或全为 solids、六个方向都被相邻子区块的实心外层遮挡且没有 DO_NOT_CULL 面时返回 false
+    static bool SectionMayHaveVisibleBlocks(int chunkX, int sectionY, int chunkZ);
+
+    // (lx, ly, lz) 为 snapshot 中的局部坐标,masks 为 snapshot.BuildFaceMasks 的结果
+    static void ProcessBlockForModel(MeshBuilder& builder, const SectionSnapshot& snapshot, const SectionFaceMasks& masks,
+        int lx, int ly, int lz);
+    // 生成子区块内 [lxBegin, lxEnd] x [lyBegin, lyEnd] x [lzBegin, lzEnd] 中需要输出的方块,只遍历有可见面的方块
+    static void ProcessSectionBlocks(MeshBuilder& builder, const SectionSnapshot& snapshot, const SectionFaceMasks& masks,
+        int lxBegin, int lxEnd, int lyBegin, int lyEnd, int lzBegin, int lzEnd);
 };
 
 #endif // CHUNK_GENERATOR_H
\ No newline at end of file
@@ -1,6 +1,7 @@
 // chunk_group_allocator.cpp
 #include "ChunkGroupAllocator.h"
 #include "LODManager.h" // 包含LODManager.h以访问g_chunkLODs
+#include "RegionIndex.h"
 #include <iostream> // 用于潜在的调试输出
 #include <limits> // 新增:用于 numeric_limits
 #include <algorithm>
@@ -40,6 +41,10 @@ namespace ChunkGroupAllocator {
 
                 for (int chunkX = groupX; chunkX <= currentGroupXEnd; ++chunkX) {
                     for (int chunkZ = groupZ; chunkZ <= currentGroupZEnd; ++chunkZ) {
+                        // 区域文件中不存在的区块不生成任务
+                        if (!RegionIndex::HasChunk(chunkX, chunkZ)) {
+                            continue;
+                        }
                         for (int sectionY = sectionYStart; sectionY <= sectionYEnd; ++sectionY) {
                             ChunkTask task;
                             task.chunkX = chunkX;
@@ -63,7 +68,10 @@ namespace ChunkGroupAllocator {
                     }
                 }
 
-                g_chunkGroups.push_back(newGroup);
+                if (newGroup.tasks.empty()) {
+                    continue;
+                }
+                g_chunkGroups.push_back(std::move(newGroup));
             }
         }
     }
@@ -125,4 +133,17 @@ namespace ChunkGroupAllocator {
         flushCurrentBatch();
     }
 
+    size_t PruneEmptyTasks(ChunkBatch& batch, const std::function<bool(const ChunkTask&)>& mayEmit)
+    {
+        size_t removed = 0;
+        for (auto& group : batch.groups) {
+            size_t before = group.tasks.size();
+            group.tasks.erase(std::remove_if(group.tasks.begin(), group.tasks.end(),
+                [&](const ChunkTask& task) { return !mayEmit(task); }), group.tasks.end());
+            removed += before - group.tasks.size();
+        }
+        batch.groups.erase(std::remove_if(batch.groups.begin(), batch.groups.end(),
+            [](const ChunkGroup& group) { return group.tasks.empty(); }), batch.groups.end());
+        return removed;
+    }
 } // namespace ChunkGroupAllocator
\ No newline at end of file
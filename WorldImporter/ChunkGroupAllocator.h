@@ -1,6 +1,7 @@
 // ChunkGroupAllocator.h
 #pragma once
 
+#include <functional>
 #include <vector>
 #include "config.h" 
 
@@ -56,4 +57,10 @@ namespace ChunkGroupAllocator {
         size_t maxTasksPerBatch = 4096  // 默认值，实际使用时会被config.maxTasksPerBatch替代
     );
 
+    /*
+     * 批次加载完成后,移除不会输出几何体的任务(mayEmit 返回 false),任务全部移除的组一并移除。
+     * 批次的区块范围保持不变(加载/卸载仍按原范围进行)。返回移除的任务数。
+     */
+    size_t PruneEmptyTasks(ChunkBatch& batch, const std::function<bool(const ChunkTask&)>& mayEmit);
+
 }
\ No newline at end of file
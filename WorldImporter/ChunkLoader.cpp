@@ -1,4 +1,6 @@
 // ChunkLoader.cpp
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -12,34 +14,48 @@
 void ChunkLoader::LoadChunks(int chunkXStart, int chunkXEnd, int chunkZStart, int chunkZEnd,
     int sectionYStart, int sectionYEnd) {
 
-    // 使用多线程加载所有相关的分块和分段
-    std::vector<std::future<void>> futures;
-
+    // 收集需要加载的区块(跳过 region 文件中不存在的区块)
+    std::vector<std::pair<int, int>> chunks;
     for (int chunkX = chunkXStart; chunkX <= chunkXEnd; ++chunkX) {
         for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ) {
-            // 新增:如果 chunk 不存在于 region 文件中或为空，则跳过加载
-            if (!HasChunk(chunkX, chunkZ)) {
-                continue;
+            if (HasChunk(chunkX, chunkZ)) {
+                chunks.emplace_back(chunkX, chunkZ);
             }
-            futures.push_back(std::async(std::launch::async, [&, chunkX, chunkZ]() {
+        }
+    }
+
+    // 固定数量的工作线程从共享下标领取区块;区块在锁外并行解析
+    unsigned numThreads = std::max<unsigned>(1, std::thread::hardware_concurrency());
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, chunks.size()));
+    std::atomic<size_t> chunkIndex{ 0 };
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+
+    for (unsigned i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t idx = chunkIndex.fetch_add(1);
+                if (idx >= chunks.size()) break;
+                int chunkX = chunks[idx].first;
+                int chunkZ = chunks[idx].second;
+
                 LoadAndCacheBlockData(chunkX, chunkZ);
+
+                // 确保条目存在（可能由RegionModelExporter预先创建以存储LOD）
+                // 如果不存在，则创建一个新的条目并设置加载状态
+                // LOD值在此处不设置，它由RegionModelExporter负责
+                std::unique_lock<std::shared_mutex> lock(g_chunkSectionInfoMapMutex);
                 for (int sectionY = sectionYStart; sectionY <= sectionYEnd; ++sectionY) {
                     auto key = std::make_tuple(chunkX, sectionY, chunkZ);
-                    // 确保条目存在（可能由RegionModelExporter预先创建以存储LOD）
-                    // 如果不存在，则创建一个新的条目并设置加载状态
-                    // LOD值在此处不设置，它由RegionModelExporter负责
-                    {
-                        std::unique_lock<std::shared_mutex> lock(g_chunkSectionInfoMapMutex);
-                        g_chunkSectionInfoMap[key].isLoaded.store(true, std::memory_order_release);
-                    }
+                    g_chunkSectionInfoMap[key].isLoaded.store(true, std::memory_order_release);
                 }
-                }));
-        }
+            }
+        });
     }
 
     // 等待所有线程完成
-    for (auto& future : futures) {
-        future.get();
+    for (auto& t : threads) {
+        t.join();
     }
 }
 
@@ -47,43 +63,33 @@ void ChunkLoader::UnloadChunks(int chunkXStart, int chunkXEnd, int chunkZStart,
     int sectionYStart, int sectionYEnd,
     const std::unordered_set<std::pair<int, int>, pair_hash>& retain_expanded_chunks) {
     // 卸载指定范围的区块和分段
-    std::vector<std::future<void>> futures;
+    // 每个区块只是从各个表中摘除(区块对象由 EpochManager 延迟释放),开销很小,
+    // 顺序执行即可;可以与其他批次的网格生成同时运行
     for (int chunkX = chunkXStart; chunkX <= chunkXEnd; ++chunkX) {
         for (int chunkZ = chunkZStart; chunkZ <= chunkZEnd; ++chunkZ) {
-            futures.push_back(std::async(std::launch::async, [=, &retain_expanded_chunks]() {
-                // 如果区块在保留集合中，则跳过卸载
-                if (retain_expanded_chunks.count({chunkX, chunkZ})) {
-                    return;
-                }
+            // 如果区块在保留集合中，则跳过卸载
+            if (retain_expanded_chunks.count({chunkX, chunkZ})) {
+                continue;
+            }
 
-                // 清理 g_chunkSectionInfoMap (使用原始 sectionY)
+            // 清理 g_chunkSectionInfoMap (使用原始 sectionY)
+            {
+                std::unique_lock<std::shared_mutex> lock(g_chunkSectionInfoMapMutex);
                 for (int sectionY = sectionYStart; sectionY <= sectionYEnd; ++sectionY) {
-                    auto g_map_key = std::make_tuple(chunkX, sectionY, chunkZ);
-                    {
-                        std::unique_lock<std::shared_mutex> lock(g_chunkSectionInfoMapMutex);
-                        g_chunkSectionInfoMap.erase(g_map_key);
-                    }
+                    g_chunkSectionInfoMap.erase(std::make_tuple(chunkX, sectionY, chunkZ));
                 }
+            }
 
-                // 清理 sectionCache 中与该 (chunkX, chunkZ) 相关的所有条目
-                ClearSectionCacheForChunk(chunkX, chunkZ);
+            // 清理子区块存储中该 (chunkX, chunkZ) 的区块(含高度图)
+            ClearSectionCacheForChunk(chunkX, chunkZ);
 
-                // 卸载与区块相关的实体方块及高度图缓存
-                // 确保这些操作在 sectionY 循环之外，并使用正确的互斥锁
-                {
-                    std::unique_lock<std::shared_mutex> lock(entityBlockCacheMutex); // 使用 entityBlockCacheMutex
-                    EntityBlockCache.erase(std::make_pair(chunkX, chunkZ));
-                }
-                {
-                    std::unique_lock<std::shared_mutex> lock(heightMapCacheMutex); // 使用 heightMapCacheMutex
-                    heightMapCache.erase(std::make_pair(chunkX, chunkZ));
-                }
-            }));
+            // 卸载与区块相关的实体方块
+            {
+                std::unique_lock<std::shared_mutex> lock(entityBlockCacheMutex); // 使用 entityBlockCacheMutex
+                EntityBlockCache.erase(std::make_pair(chunkX, chunkZ));
+            }
         }
     }
-    for (auto& f : futures) {
-        f.get();
-    }
 }
 
 void ChunkLoader::CalculateChunkLODs(int expandedChunkXStart, int expandedChunkXEnd, int expandedChunkZStart, int expandedChunkZEnd,
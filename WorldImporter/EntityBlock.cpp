@@ -1,9 +1,11 @@
 #include "EntityBlock.h"
 #include "RegionModelExporter.h"  // 包含必要的头文件,确保相关函数可用
-#include "blockstate.h"         // 为了调用 ProcessBlockstate
+#include "LittleTilesMesher.h"
+#include "BakedModel.h"
+#include <algorithm>
+#include <cstdint>
 #include <span>                  // 为了 std::span (C++20)
 #include <iostream>            // 为了 std::cout, std::cerr (如果尚未包含)
-#include <map>
 #include <vector>
 #include <string>
 
@@ -27,57 +29,103 @@ void YuushyaShowBlockEntity::PrintDetails() const {
     }
 }
 
-ModelData YuushyaShowBlockEntity::GenerateModel() const {
-    ModelData mainModel;
-    for (const auto& block : blocks) {
-        int id = block.blockid;
-        // 位置偏移(除以16转换到模型空间)
-        double tx = block.showPos[0] / 16.0f;
-        double ty = block.showPos[1] / 16.0f;
-        double tz = block.showPos[2] / 16.0f;
-
-        // 旋转参数(直接使用原始值)
-        float rx = block.showRotation[0]; // 假设已是角度值
-        float ry = block.showRotation[1];
-        float rz = block.showRotation[2];
+// 显示的方块:blocks 中 isShown 且变换参数完整的条目
+static bool IsPartShown(const YuushyaBlockEntry& block) {
+    return block.isShown && block.showPos.size() >= 3 && block.showRotation.size() >= 3 && block.showScales.size() >= 3;
+}
 
-        // 缩放参数
-        float sx = block.showScales[0];
-        float sy = block.showScales[1];
-        float sz = block.showScales[2];
+// 把数值的二进制内容追加到键中
+template <typename T>
+static void AppendKeyBytes(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
 
-        if (!block.isShown) continue;
+// 按实体方块坐标与子模型序号确定随机模型(按权重)的下标
+// 同一位置每次选择相同,CollectParts 生成的键与 GeneratePart 生成的模型一致,不同位置仍各自随机
+static size_t PickVariant(const BakedModel& baked, int x, int y, int z, size_t partIndex) {
+    if (baked.variants.size() <= 1) return 0;
+    uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(x)) * 0x9E3779B97F4A7C15ull;
+    h ^= static_cast<uint64_t>(static_cast<uint32_t>(y)) * 0xC2B2AE3D27D4EB4Full;
+    h ^= static_cast<uint64_t>(static_cast<uint32_t>(z)) * 0x165667B19E3779F9ull;
+    h ^= static_cast<uint64_t>(partIndex) * 0x27D4EB2F165667C5ull;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 32;
+    const int weight = static_cast<int>(h % static_cast<uint64_t>(baked.cumulativeWeights.back())) + 1;
+    return std::lower_bound(baked.cumulativeWeights.begin(), baked.cumulativeWeights.end(), weight) - baked.cumulativeWeights.begin();
+}
 
-        Block b = GetBlockById(id);
-        std::string blockName = b.GetModifiedNameWithNamespace();
-        std::string ns = b.GetNamespace();
-        // 获取模型数据
-        size_t colonPos = blockName.find(':');
-        if (colonPos != std::string::npos) blockName = blockName.substr(colonPos + 1);
-        ModelData blockModel = GetRandomModelFromCache(ns, blockName);
+void YuushyaShowBlockEntity::CollectParts(std::vector<EntityPart>& parts) const {
+    size_t partIndex = 0;
+    for (const auto& block : blocks) {
+        if (!IsPartShown(block)) continue;
+        const size_t variant = PickVariant(bakedModels.Get(block.blockid), x, y, z, partIndex++);
+
+        // 变换顺序为 旋转 -> 平移 -> 缩放(以 0.5 为中心),
+        // 缩放后的平移等于 缩放 × 平移,因此子模型只需旋转和缩放,平移归入实例偏移
+        EntityPart part;
+        part.key = "Y";
+        AppendKeyBytes(part.key, block.blockid);
+        AppendKeyBytes(part.key, variant);
+        for (int i = 0; i < 3; ++i) AppendKeyBytes(part.key, block.showRotation[i]);
+        for (int i = 0; i < 3; ++i) AppendKeyBytes(part.key, block.showScales[i]);
+        part.dx = x + block.showScales[0] * (block.showPos[0] / 16.0f);
+        part.dy = y + block.showScales[1] * (block.showPos[1] / 16.0f);
+        part.dz = z + block.showScales[2] * (block.showPos[2] / 16.0f);
+        parts.push_back(std::move(part));
+    }
+}
 
-        // 如果缓存未命中,尝试处理 blockstate 并重新获取模型
-        if (blockModel.vertices.empty() && !blockName.empty()) {
-            ProcessBlockstate(ns, {blockName}); // blockName 应包含方块状态, ns 是命名空间
-            blockModel = GetRandomModelFromCache(ns, blockName); // 再次尝试获取
+ModelData YuushyaShowBlockEntity::GeneratePart(size_t partIndex) const {
+    const YuushyaBlockEntry* entry = nullptr;
+    size_t shownIndex = 0;
+    for (const auto& block : blocks) {
+        if (IsPartShown(block) && shownIndex++ == partIndex) {
+            entry = &block;
+            break;
         }
+    }
+    if (!entry) return ModelData();
+
+    const int id = entry->blockid;
+    // 旋转参数(直接使用原始值)
+    float rx = entry->showRotation[0]; // 假设已是角度值
+    float ry = entry->showRotation[1];
+    float rz = entry->showRotation[2];
+
+    // 缩放参数
+    float sx = entry->showScales[0];
+    float sy = entry->showScales[1];
+    float sz = entry->showScales[2];
+
+    // 方块状态在解析实体时已加入调色板并烘焙,按与 CollectParts 相同的规则选择随机模型
+    const BakedModel& baked = bakedModels.Get(id);
+    if (baked.variants.empty()) return ModelData();
+    ModelData blockModel = baked.variants[PickVariant(baked, x, y, z, partIndex)];
+
+    // 将所有面设置为DO_NOT_CULL,确保不会被贪心合并算法错误剔除
+    for (auto& face : blockModel.faces) {
+        face.faceDirection = DO_NOT_CULL;
+    }
 
-        // 将所有面设置为DO_NOT_CULL,确保不会被贪心合并算法错误剔除
-        for (auto& face : blockModel.faces) {
-            face.faceDirection = DO_NOT_CULL;
-        }
+    ApplyRotationToVertices(std::span<float>(blockModel.vertices.data(), blockModel.vertices.size()), rx, ry, rz);
+    ApplyScaleToVertices(std::span<float>(blockModel.vertices.data(), blockModel.vertices.size()), sx, sy, sz);
+    return blockModel;
+}
 
-        // 应用变换顺序:缩放 -> 旋转 -> 平移
-        ApplyRotationToVertices(std::span<float>(blockModel.vertices.data(), blockModel.vertices.size()), rx, ry, rz);
+ModelData EntityBlock::GenerateModel() const {
+    std::vector<EntityPart> parts;
+    CollectParts(parts);
 
-        ApplyDoublePositionOffset(blockModel, tx, ty, tz);
-        ApplyScaleToVertices(std::span<float>(blockModel.vertices.data(), blockModel.vertices.size()), sx, sy, sz);
+    ModelData mainModel;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        ModelData partModel = GeneratePart(i);
+        ApplyDoublePositionOffset(partModel, parts[i].dx, parts[i].dy, parts[i].dz);
 
         // 合并模型
-        if (mainModel.vertices.empty()) mainModel = blockModel;
-        else MergeModelsDirectly(mainModel, blockModel);
+        if (mainModel.vertices.empty()) mainModel = std::move(partModel);
+        else MergeModelsDirectly(mainModel, partModel);
     }
-    ApplyPositionOffset(mainModel, x, y, z); // 最终整体偏移
     return mainModel;
 }
 
@@ -126,210 +174,45 @@ void LittleTilesTilesEntity::PrintDetails() const {
     }
 }
 
-// 检查面是否被完全覆盖,如果是则应被剔除
-static bool IsFaceCovered(LittleFaceState state) {
-    return state == LittleFaceState::INSIDE_COVERED || state == LittleFaceState::OUTSIDE_COVERED;
-}
-
-ModelData CreateCube(float minX, float minY, float minZ, float maxX, float maxY, float maxZ, const ModelData& templateModel, std::span<const int> faceStates) {
-    ModelData cubeModel;
-
-    // 1. 复制材质
-    cubeModel.materials = templateModel.materials;
-
-    // 2. 构建面-材质映射
-    std::map<FaceType, int> faceMaterialMap;
-    int anySideMaterial = -1;
-    for (const auto& face : templateModel.faces) {
-        if (faceMaterialMap.find(face.faceDirection) == faceMaterialMap.end()) {
-            faceMaterialMap[face.faceDirection] = face.materialIndex;
-        }
-        if (anySideMaterial == -1 && (face.faceDirection == NORTH || face.faceDirection == SOUTH || face.faceDirection == EAST || face.faceDirection == WEST)) {
-            anySideMaterial = face.materialIndex;
-        }
-    }
-
-    auto getMaterialForFace = [&](FaceType dir) -> int {
-        auto it = faceMaterialMap.find(dir);
-        if (it != faceMaterialMap.end()) {
-            return it->second;
-        }
-        // 侧面的备用方案
-        if (dir == NORTH || dir == SOUTH || dir == EAST || dir == WEST) {
-            if (anySideMaterial != -1) return anySideMaterial;
-        }
-        // 顶部/底部的备用方案
-        auto it_up = faceMaterialMap.find(UP);
-        if (it_up != faceMaterialMap.end()) return it_up->second;
-        auto it_down = faceMaterialMap.find(DOWN);
-        if (it_down != faceMaterialMap.end()) return it_down->second;
-
-        if (anySideMaterial != -1) return anySideMaterial; // 再次尝试侧面
-        if (!faceMaterialMap.empty()) return faceMaterialMap.begin()->second; // 尝试任何一个
-        return 0; // 最后手段
-    };
-
-    // 3. 为6个独立的面创建顶点 (每个面4个顶点)
-    cubeModel.vertices = {
-        // 上 (Y max). 从顶部看逆时针: (minX,maxY,minZ), (maxX,maxY,minZ), (maxX,maxY,maxZ), (minX,maxY,maxZ)
-        minX, maxY, minZ,   maxX, maxY, minZ,   maxX, maxY, maxZ,   minX, maxY, maxZ,
-        // 下 (Y min). 从底部看逆时针: (minX,minY,maxZ), (maxX,minY,maxZ), (maxX,minY,minZ), (minX,minY,minZ)
-        minX, minY, maxZ,   maxX, minY, maxZ,   maxX, minY, minZ,   minX, minY, minZ,
-        // 东 (X max). 从东面看逆时针: (maxX,minY,minZ), (maxX,maxY,minZ), (maxX,maxY,maxZ), (maxX,minY,maxZ)
-        maxX, minY, minZ,   maxX, maxY, minZ,   maxX, maxY, maxZ,   maxX, minY, maxZ,
-        // 西 (X min). 从西面看逆时針: (minX,minY,maxZ), (minX,maxY,maxZ), (minX,maxY,minZ), (minX,minY,minZ)
-        minX, minY, maxZ,   minX, maxY, maxZ,   minX, maxY, minZ,   minX, minY, minZ,
-        // 北 (Z min). 从北面看逆时针: (minX,minY,minZ), (maxX,minY,minZ), (maxX,maxY,minZ), (minX,maxY,minZ)
-        minX, minY, minZ,   maxX, minY, minZ,   maxX, maxY, minZ,   minX, maxY, minZ,
-        // 南 (Z max). 从南面看逆时针: (maxX,minY,maxZ), (minX,minY,maxZ), (minX,maxY,maxZ), (maxX,maxY,maxZ)
-        maxX, minY, maxZ,   minX, minY, maxZ,   minX, maxY, maxZ,   maxX, maxY, maxZ
-    };
-
-    // 4. UV坐标 (每个顶点一对)
-    cubeModel.uvCoordinates = {
-        // 上 (XZ平面)
-        minX, minZ,   maxX, minZ,   maxX, maxZ,   minX, maxZ,
-        // 下 (XZ平面)
-        minX, maxZ,   maxX, maxZ,   maxX, minZ,   minX, minZ,
-        // 东 (ZY平面)
-        minZ, minY,   minZ, maxY,   maxZ, maxY,   maxZ, minY,
-        // 西 (ZY平面)
-        maxZ, minY,   maxZ, maxY,   minZ, maxY,   minZ, minY,
-        // 北 (XY平面)
-        minX, minY,   maxX, minY,   maxX, maxY,   minX, maxY,
-        // 南 (XY平面)
-        maxX, minY,   minX, minY,   minX, maxY,   maxX, maxY
-    };
-
-    // 5. 面 - 根据faceStates决定是否生成
-    struct FaceInfo {
-        FaceType type;
-        std::array<int, 4> vertIndices;
-        std::array<int, 4> uvIndices;
-    };
-
-    const std::vector<FaceInfo> faceInfos = {
-        {UP,    {0, 1, 2, 3},    {0, 1, 2, 3}},
-        {DOWN,  {4, 5, 6, 7},    {4, 5, 6, 7}},
-        {EAST,  {8, 9, 10, 11},  {8, 9, 10, 11}},
-        {WEST,  {12, 13, 14, 15}, {12, 13, 14, 15}},
-        {NORTH, {16, 17, 18, 19}, {16, 17, 18, 19}},
-        {SOUTH, {20, 21, 22, 23}, {20, 21, 22, 23}}
-    };
-
-    // 根据 EntityBlock.h 中的注释, faceStates 的顺序是 EAST, WEST, UP, DOWN, SOUTH, NORTH
-    std::map<FaceType, LittleFaceState> stateMap;
-    if (faceStates.size() >= 6) {
-        stateMap[FaceType::UP] = static_cast<LittleFaceState>(faceStates[0]);
-        stateMap[FaceType::DOWN] = static_cast<LittleFaceState>(faceStates[1]);
-        stateMap[FaceType::SOUTH] = static_cast<LittleFaceState>(faceStates[2]);
-        stateMap[FaceType::NORTH] = static_cast<LittleFaceState>(faceStates[3]);
-        stateMap[FaceType::EAST] = static_cast<LittleFaceState>(faceStates[4]);
-        stateMap[FaceType::WEST] = static_cast<LittleFaceState>(faceStates[5]);
-    }
-
-
-    for (const auto& info : faceInfos) {
-        LittleFaceState state = LittleFaceState::UNLOADED;
-        if (stateMap.count(info.type)) {
-            state = stateMap.at(info.type);
-        }
-        if (!IsFaceCovered(state)) {
-            cubeModel.faces.push_back({ info.vertIndices, info.uvIndices, getMaterialForFace(info.type), info.type });
-        }
-    }
-
-    return cubeModel;
-}
-
-// --- 新增辅助函数 ---
-// 根据给定的tiles和grid生成模型,不应用最终的位置偏移
-static ModelData GenerateModelFromTiles(const std::vector<LittleTilesTileEntry>& tiles, int grid) {
-    ModelData model;
-    float grid_f = static_cast<float>(grid);
-
+// tiles 的内容键:grid 与每个 tile 的方块名和 boxData
+static std::string TilesKey(const std::vector<LittleTilesTileEntry>& tiles, int grid) {
+    std::string key = "L";
+    AppendKeyBytes(key, grid);
     for (const auto& tile : tiles) {
-        // 获取方块类型的模板模型
-        std::string fullBlockName = tile.blockName;
-        std::string ns = "minecraft"; // 默认命名空间
-        std::string blockName;
-        size_t colonPos = fullBlockName.find(':');
-        if (colonPos != std::string::npos) {
-            ns = fullBlockName.substr(0, colonPos);
-            blockName = fullBlockName.substr(colonPos + 1);
-        }
-        else {
-            blockName = fullBlockName;
-        }
-
-        ModelData templateModel = GetRandomModelFromCache(ns, blockName);
-        if (templateModel.vertices.empty() && !blockName.empty()) {
-            ProcessBlockstate(ns, { blockName });
-            templateModel = GetRandomModelFromCache(ns, blockName);
-        }
-
-        if (templateModel.materials.empty()) {
-            // 如果没有材质,创建一个虚拟材质以防止崩溃
-            Material dummyMaterial;
-            dummyMaterial.name = "dummy";
-            dummyMaterial.texturePath = "None";
-            templateModel.materials.push_back(dummyMaterial);
-        }
-
+        AppendKeyBytes(key, tile.blockName.size());
+        key += tile.blockName;
+        AppendKeyBytes(key, tile.boxDataList.size());
         for (const auto& boxData : tile.boxDataList) {
-            if (boxData.size() != 12) continue; // 现在需要12个元素
-
-            // 从 boxData 中提取位置和大小
-            int minX = boxData[6];
-            int minY = boxData[7];
-            int minZ = boxData[8];
-            int maxX = boxData[9];
-            int maxY = boxData[10];
-            int maxZ = boxData[11];
-
-            // 为该 box 创建立方体模型,并传入面状态
-            ModelData cube = CreateCube(minX / grid_f, minY / grid_f, minZ / grid_f, maxX / grid_f, maxY / grid_f, maxZ / grid_f, templateModel, std::span<const int>(boxData.data(), 6));
-
-            // 合并到最终模型中
-            if (model.vertices.empty()) {
-                model = cube;
-            }
-            else {
-                MergeModelsDirectly(model, cube);  // 假设 MergeModelsDirectly 已定义
-            }
+            AppendKeyBytes(key, boxData.size());
+            key.append(reinterpret_cast<const char*>(boxData.data()), boxData.size() * sizeof(int));
         }
     }
-    return model;
+    return key;
 }
 
-ModelData LittleTilesTilesEntity::GenerateModel() const {
-    // 1. 生成父结构的本地模型
-    ModelData finalModel = GenerateModelFromTiles(this->tiles, this->grid);
-
-    // 2. 遍历子结构,生成它们的模型并合并
-    for (const auto& child : this->children) {
-        // 假设子结构继承父结构的 grid 设置
-        ModelData childModel = GenerateModelFromTiles(child.tiles, this->grid);
+void LittleTilesTilesEntity::CollectParts(std::vector<EntityPart>& parts) const {
+    // 0 号子模型为父结构自身的 tiles
+    parts.push_back({ TilesKey(tiles, grid), static_cast<double>(x), static_cast<double>(y), static_cast<double>(z) });
 
-        // 应用子结构的相对坐标偏移(根据grid缩放)
+    // 子结构继承父结构的 grid 设置,相对坐标按 grid 缩放
+    for (const auto& child : children) {
+        EntityPart part{ TilesKey(child.tiles, grid), static_cast<double>(x), static_cast<double>(y), static_cast<double>(z) };
         if (child.coord.size() >= 3) {
-            float grid_f = static_cast<float>(this->grid);
-            double offsetX = static_cast<double>(child.coord[0]) / grid_f;
-            double offsetY = static_cast<double>(child.coord[1]) / grid_f;
-            double offsetZ = static_cast<double>(child.coord[2]) / grid_f;
-            ApplyDoublePositionOffset(childModel, offsetX, offsetY, offsetZ);
-        }
-
-        // 合并到最终模型中
-        if (finalModel.vertices.empty()) {
-            finalModel = childModel;
-        }
-        else {
-            MergeModelsDirectly(finalModel, childModel);
+            float grid_f = static_cast<float>(grid);
+            part.dx += static_cast<double>(child.coord[0]) / grid_f;
+            part.dy += static_cast<double>(child.coord[1]) / grid_f;
+            part.dz += static_cast<double>(child.coord[2]) / grid_f;
         }
+        parts.push_back(std::move(part));
     }
+}
 
-    // 3. 对最终合并的模型应用实体自身的绝对坐标偏移
-    ApplyPositionOffset(finalModel, x, y, z);
-    return finalModel;
+ModelData LittleTilesTilesEntity::GeneratePart(size_t partIndex) const {
+    if (partIndex == 0) {
+        return LittleTilesMesher::Mesh(tiles, grid);
+    }
+    if (partIndex - 1 < children.size()) {
+        return LittleTilesMesher::Mesh(children[partIndex - 1].tiles, grid);
+    }
+    return ModelData();
 }
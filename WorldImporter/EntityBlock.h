@@ -5,14 +5,28 @@
 #include <vector>
 #include "model.h" // 假设 ModelData 定义在这个头文件中
 
+// 实体方块的一个子模型实例
+// key 为子模型内容的序列化,内容相同的子模型(同一方块状态/随机模型/旋转/缩放,或同一组 tiles)键相同,只需生成一次;
+// 子模型在局部坐标生成,实例只差一个平移 (dx, dy, dz)(已包含实体方块自身的坐标)
+struct EntityPart {
+    std::string key;
+    double dx, dy, dz;
+};
+
 struct EntityBlock {
     std::string id;  // 实体方块的ID
     int x, y, z;     // 实体方块的坐标
 
     virtual ~EntityBlock() = default;  // 虚析构函数,以便正确析构派生类对象
     virtual void PrintDetails() const;
-    // 新增的虚函数
-    virtual ModelData GenerateModel() const = 0;  // 纯虚函数,要求派生类实现
+
+    // 拆分为子模型实例,追加到 parts;第 i 个追加的实例由 GeneratePart(i) 生成
+    virtual void CollectParts(std::vector<EntityPart>& parts) const = 0;
+    // 生成第 partIndex 个子模型(局部坐标,不含平移)
+    virtual ModelData GeneratePart(size_t partIndex) const = 0;
+
+    // 生成整个实体方块的模型(世界坐标),等价于逐个生成子模型后平移合并
+    ModelData GenerateModel() const;
 };
 
 struct YuushyaBlockEntry {
@@ -30,11 +44,11 @@ struct YuushyaShowBlockEntity : public EntityBlock {
     int controlSlot;  // ControlSlot
     bool keepPacked;  // keepPacked
 
-    // 输出实体详细信息
     // 输出实体详细信息
     void PrintDetails() const override;
-    // 生成模型的声明
-    ModelData GenerateModel() const override;
+    // 每个显示的方块为一个子模型
+    void CollectParts(std::vector<EntityPart>& parts) const override;
+    ModelData GeneratePart(size_t partIndex) const override;
 };
 
 enum class LittleFaceState {
@@ -68,7 +82,9 @@ struct LittleTilesTilesEntity : public EntityBlock {
     int grid = 16; // 小方块的精度,默认为16
 
     void PrintDetails() const override;
-    ModelData GenerateModel() const override;
+    // 自身的 tiles 与每个子结构的 tiles 各为一个子模型
+    void CollectParts(std::vector<EntityPart>& parts) const override;
+    ModelData GeneratePart(size_t partIndex) const override;
 };
 
 #endif
\ No newline at end of file
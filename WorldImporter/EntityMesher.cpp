@@ -0,0 +1,101 @@
+// EntityMesher.cpp
+#include "EntityMesher.h"
+#include "EntityBlock.h"
+#include "MaterialRegistry.h"
+#include "MeshBuilder.h"
+#include "block.h"
+#include "hashutils.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+void EntityMesher::Prepare(const std::vector<ChunkGroup>& groups, const std::function<bool(const ChunkTask&)>& fullDetail) {
+    Clear();
+    m_groupInstances.resize(groups.size());
+
+    // 每个子模型由哪个实体方块的第几个子模型生成
+    struct PartSource {
+        std::shared_ptr<EntityBlock> entity;
+        size_t index;
+    };
+    std::vector<PartSource> sources;
+    std::unordered_map<std::string, size_t> partByKey;
+    std::vector<EntityPart> entityParts;
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        std::unordered_set<std::pair<int, int>, pair_hash> visitedChunks;
+        for (const auto& task : groups[g].tasks) {
+            if (!fullDetail(task)) continue;
+            const auto chunkKey = std::make_pair(task.chunkX, task.chunkZ);
+            if (!visitedChunks.insert(chunkKey).second) continue;
+
+            // 在共享锁下复制实体列表(只复制 shared_ptr)
+            std::vector<std::shared_ptr<EntityBlock>> entityBlocks;
+            {
+                std::shared_lock<std::shared_mutex> lock(entityBlockCacheMutex);
+                auto it = EntityBlockCache.find(chunkKey);
+                if (it != EntityBlockCache.end()) {
+                    entityBlocks = it->second;
+                }
+            }
+
+            for (const auto& entity : entityBlocks) {
+                if (entity == nullptr) continue;
+                entityParts.clear();
+                entity->CollectParts(entityParts);
+                for (size_t i = 0; i < entityParts.size(); ++i) {
+                    auto [it, inserted] = partByKey.try_emplace(std::move(entityParts[i].key), sources.size());
+                    if (inserted) {
+                        sources.push_back({ entity, i });
+                    }
+                    m_groupInstances[g].push_back({ it->second, entityParts[i].dx, entityParts[i].dy, entityParts[i].dz });
+                    ++m_instanceCount;
+                }
+            }
+        }
+    }
+    if (sources.empty()) return;
+
+    // 去重后的子模型并行生成,材质在这里登记一次
+    m_parts.resize(sources.size());
+    std::atomic<size_t> nextPart{ 0 };
+    const unsigned numThreads = static_cast<unsigned>((std::min<size_t>)(
+        (std::max)(1u, std::thread::hardware_concurrency()), sources.size()));
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads);
+    for (unsigned t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&]() {
+            while (true) {
+                const size_t i = nextPart.fetch_add(1);
+                if (i >= sources.size()) break;
+                PartModel& part = m_parts[i];
+                part.model = sources[i].entity->GeneratePart(sources[i].index);
+                materialRegistry.InternAll(part.model.materials, part.materialIds);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void EntityMesher::AppendGroup(size_t groupIndex, MeshBuilder& builder) const {
+    if (groupIndex >= m_groupInstances.size()) return;
+    for (const auto& instance : m_groupInstances[groupIndex]) {
+        const PartModel& part = m_parts[instance.part];
+        builder.AppendInstance(part.model, instance.dx, instance.dy, instance.dz, &part.materialIds);
+    }
+}
+
+void EntityMesher::Clear() {
+    m_parts.clear();
+    m_groupInstances.clear();
+    m_instanceCount = 0;
+}
@@ -0,0 +1,46 @@
+// EntityMesher.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "ChunkGroupAllocator.h"
+#include "model.h"
+
+class MeshBuilder;
+
+// 实体方块网格生成:每个批次在网格线程开始前单独执行
+// 批次内所有实体方块拆分为子模型实例(EntityPart),内容相同的子模型只生成一次(多线程并行),
+// 各组生成网格时按实例偏移追加共享的子模型,不再为每个实体方块单独生成并合并整个模型。
+class EntityMesher {
+public:
+    // 收集批次内各组的实体方块并生成去重后的子模型
+    // fullDetail 返回 true 的任务所在区块才输出实体方块(LOD 区块不输出),每个区块只输出一次
+    void Prepare(const std::vector<ChunkGroup>& groups, const std::function<bool(const ChunkTask&)>& fullDetail);
+
+    // 把第 groupIndex 组的实体方块实例追加到构建器
+    void AppendGroup(size_t groupIndex, MeshBuilder& builder) const;
+
+    // 释放当前批次的子模型
+    void Clear();
+
+    // 当前批次的实例数与去重后的子模型数
+    size_t InstanceCount() const { return m_instanceCount; }
+    size_t UniquePartCount() const { return m_parts.size(); }
+
+private:
+    struct PartModel {
+        ModelData model;
+        std::vector<uint32_t> materialIds; // 子模型局部材质 -> materialRegistry 中的ID
+    };
+
+    struct Instance {
+        size_t part;
+        double dx, dy, dz;
+    };
+
+    std::vector<PartModel> m_parts;
+    std::vector<std::vector<Instance>> m_groupInstances;
+    size_t m_instanceCount = 0;
+};
@@ -0,0 +1,127 @@
+// EpochManager.cpp
+#include "EpochManager.h"
+#include <limits>
+
+namespace {
+    // 积压超过该数量时 Retire 顺带尝试回收
+    constexpr size_t kReclaimThreshold = 256;
+}
+
+EpochManager& EpochManager::GetInstance() {
+    static EpochManager instance;
+    return instance;
+}
+
+EpochManager::ThreadRecord& EpochManager::LocalRecord() {
+    // 线程退出时归还记录
+    struct LocalSlot {
+        ThreadRecord* record = nullptr;
+        ~LocalSlot() {
+            if (record) {
+                record->epoch.store(0, std::memory_order_release);
+                record->inUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local LocalSlot slot;
+    if (slot.record) {
+        return *slot.record;
+    }
+
+    // 优先复用已退出线程的记录
+    for (ThreadRecord* record = m_records.load(std::memory_order_acquire); record; record = record->next) {
+        bool expected = false;
+        if (!record->inUse.load(std::memory_order_relaxed) &&
+            record->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            record->depth = 0;
+            slot.record = record;
+            return *record;
+        }
+    }
+
+    // 记录只增不删,读取链表无需加锁
+    ThreadRecord* record = new ThreadRecord();
+    record->inUse.store(true, std::memory_order_relaxed);
+    ThreadRecord* head = m_records.load(std::memory_order_relaxed);
+    do {
+        record->next = head;
+    } while (!m_records.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+    slot.record = record;
+    return *record;
+}
+
+void EpochManager::Enter() {
+    ThreadRecord& record = LocalRecord();
+    if (record.depth++ > 0) {
+        return;
+    }
+    record.epoch.store(m_globalEpoch.load(std::memory_order_seq_cst), std::memory_order_relaxed);
+    // 先公布纪元再读取共享指针,与 Retire 一侧的栅栏配对
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochManager::Leave() {
+    ThreadRecord& record = LocalRecord();
+    if (--record.depth > 0) {
+        return;
+    }
+    record.epoch.store(0, std::memory_order_release);
+}
+
+void EpochManager::Retire(std::function<void()> deleter) {
+    // 调用方已经摘除对象;推进纪元后,之后进入的读线程不可能再看到它
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t epoch = m_globalEpoch.fetch_add(1, std::memory_order_seq_cst);
+
+    size_t pending;
+    {
+        std::lock_guard<std::mutex> lock(m_retireMutex);
+        m_retired.push_back({ epoch, std::move(deleter) });
+        pending = m_retired.size();
+    }
+    if (pending >= kReclaimThreshold) {
+        Reclaim();
+    }
+}
+
+uint64_t EpochManager::MinActiveEpoch() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t minEpoch = std::numeric_limits<uint64_t>::max();
+    for (ThreadRecord* record = m_records.load(std::memory_order_acquire); record; record = record->next) {
+        uint64_t epoch = record->epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0 && epoch < minEpoch) {
+            minEpoch = epoch;
+        }
+    }
+    return minEpoch;
+}
+
+size_t EpochManager::Reclaim() {
+    // 在 Retire 时纪元为 e 的对象,只可能被纪元 <= e 的读线程引用
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_retireMutex);
+        const uint64_t minActive = MinActiveEpoch();
+        auto keep = m_retired.begin();
+        for (auto it = m_retired.begin(); it != m_retired.end(); ++it) {
+            if (it->epoch < minActive) {
+                ready.push_back(std::move(it->deleter));
+            }
+            else {
+                *keep++ = std::move(*it);
+            }
+        }
+        m_retired.erase(keep, m_retired.end());
+    }
+
+    // 在锁外执行释放
+    for (auto& deleter : ready) {
+        deleter();
+    }
+    return ready.size();
+}
+
+size_t EpochManager::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(m_retireMutex);
+    return m_retired.size();
+}
@@ -0,0 +1,68 @@
+// EpochManager.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// 基于纪元(epoch)的延迟回收
+// 读线程在 EpochGuard 作用域内无锁访问共享数据;写线程先把对象从共享结构中摘除,
+// 再调用 Retire 交给这里,等所有可能看到旧指针的读线程离开作用域后才真正释放。
+class EpochManager {
+public:
+    // 获取单例实例
+    static EpochManager& GetInstance();
+
+    // 进入/离开读作用域(可嵌套,只有最外层生效);一般通过 EpochGuard 使用
+    void Enter();
+    void Leave();
+
+    // 登记一个已从共享结构中摘除的对象,deleter 会在安全时调用
+    void Retire(std::function<void()> deleter);
+
+    // 释放所有已经没有读线程可能引用的对象,返回释放的数量
+    size_t Reclaim();
+
+    // 尚未释放的对象数
+    size_t GetPendingCount() const;
+
+private:
+    EpochManager() = default;
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    // 每个线程一条记录,线程退出后记录留在链表中供后续线程复用
+    struct ThreadRecord {
+        std::atomic<uint64_t> epoch{ 0 }; // 0 表示不在读作用域内
+        std::atomic<bool> inUse{ false };
+        int depth = 0;
+        ThreadRecord* next = nullptr;
+    };
+
+    struct RetiredObject {
+        uint64_t epoch;
+        std::function<void()> deleter;
+    };
+
+    ThreadRecord& LocalRecord();
+    uint64_t MinActiveEpoch() const;
+
+    std::atomic<uint64_t> m_globalEpoch{ 1 };
+    std::atomic<ThreadRecord*> m_records{ nullptr };
+
+    mutable std::mutex m_retireMutex;
+    std::vector<RetiredObject> m_retired;
+};
+
+// 读作用域:作用域内通过 SectionGrid 等结构取得的指针不会被释放
+class EpochGuard {
+public:
+    EpochGuard() { EpochManager::GetInstance().Enter(); }
+    ~EpochGuard() { EpochManager::GetInstance().Leave(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
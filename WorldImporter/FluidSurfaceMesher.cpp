@@ -0,0 +1,186 @@
+// FluidSurfaceMesher.cpp
+#include "FluidSurfaceMesher.h"
+#include "BakedModel.h"
+#include "BlockTraits.h"
+#include "config.h"
+#include "fluid.h"
+#include <bit>
+#include <vector>
+
+extern Config config;
+
+namespace {
+
+    // 合并顶面的分组:材质、高度、面方向与 UV 的 V 范围都相同的面才能合并
+    struct TopSurface {
+        uint32_t materialId;
+        float height;
+        FaceType direction;
+        float vTop;    // 方块北边(z 小)的 V 坐标
+        float vBottom; // 方块南边的 V 坐标
+        bool singleFrame; // V 范围恰好为 1(单帧纹理)时才能沿 Z 平铺,多帧纹理的帧纵向排列
+    };
+
+    // 流体面方向 -> neighborIsAir 下标
+    int NeighborIndex(FaceType dir) {
+        switch (dir) {
+        case UP: return SectionFaceMasks::kUp;
+        case DOWN: return SectionFaceMasks::kDown;
+        case NORTH: return SectionFaceMasks::kNorth;
+        case SOUTH: return SectionFaceMasks::kSouth;
+        case WEST: return SectionFaceMasks::kWest;
+        case EAST: return SectionFaceMasks::kEast;
+        default: return -1;
+        }
+    }
+
+    // 与 ChunkGenerator 相同的剔除规则:DO_NOT_CULL 总是保留,其余方向邻居不遮挡时保留
+    bool KeepFace(FaceType dir, const std::array<bool, 6>& neighbors) {
+        const int neighborIdx = NeighborIndex(dir);
+        return neighborIdx < 0 || neighbors[neighborIdx];
+    }
+
+    // 方块没有自己的模型(只输出流体)
+    bool HasNoBlockModel(int id) {
+        for (const auto& variant : bakedModels.Get(id).variants) {
+            if (!variant.vertices.empty()) return false;
+        }
+        return true;
+    }
+
+}
+
+namespace FluidSurfaceMesher {
+
+    void MeshSection(MeshBuilder& builder, const SectionSnapshot& snapshot, const SectionFaceMasks& masks,
+        int lxBegin, int lxEnd, int lyBegin, int lyEnd, int lzBegin, int lzEnd,
+        std::array<uint16_t, 256>& handled) {
+        handled.fill(0);
+        if (lyBegin > lyEnd) return;
+        const uint16_t yRange = static_cast<uint16_t>(((1u << (lyEnd + 1)) - 1) & ~((1u << lyBegin) - 1));
+
+        // 每层 16x16 的顶面分组下标(0 表示该位置没有待合并的顶面)
+        std::vector<TopSurface> surfaces;
+        std::array<std::array<uint8_t, 256>, 16> topMask{};
+        std::vector<int> faceIndices;
+
+        for (int lx = lxBegin; lx <= lxEnd; ++lx) {
+            for (int lz = lzBegin; lz <= lzEnd; ++lz) {
+                const int column = SectionFaceMasks::Column(lx, lz);
+                uint16_t fluids = masks.fluid[column] & masks.nonAir[column] & yRange;
+                while (fluids) {
+                    const int ly = std::countr_zero(fluids);
+                    fluids &= fluids - 1;
+                    const uint16_t bit = static_cast<uint16_t>(1u << ly);
+
+                    // 含水方块需要与方块模型合并,交给逐方块处理
+                    const int id = snapshot.BlockId(lx, ly, lz);
+                    if (!blockTraits.IsFluid(id) || blockTraits.Level(id) < 0 || !HasNoBlockModel(id)) continue;
+
+                    // 与逐方块处理相同的过滤条件
+                    if ((config.exportLightBlockOnly && !blockTraits.IsLightBlock(id)) ||
+                        (config.cullCave && snapshot.SkyLight(lx, ly, lz) == -1)) {
+                        handled[column] |= bit;
+                        continue;
+                    }
+
+                    std::array<bool, 6> neighbors;
+                    std::array<int, 10> fluidLevels;
+                    snapshot.BlockIdWithNeighbors(lx, ly, lz, neighbors.data(), fluidLevels.data());
+                    // 只有水源和被覆盖的流体使用静止纹理,其余流体顶面的 UV 随流向旋转
+                    if (fluidLevels[0] != 0 && fluidLevels[0] != 8) continue;
+
+                    const FluidModel& fluid = fluidModels.Get(fluidLevels, blockTraits.FluidId(id));
+                    const ModelData& model = fluid.model;
+                    const Face& top = model.faces[1];
+                    const float height = model.vertices[top.vertexIndices[0] * 3 + 1];
+                    bool flat = true;
+                    for (int j = 1; j < 4; ++j) {
+                        flat = flat && model.vertices[top.vertexIndices[j] * 3 + 1] == height;
+                    }
+                    if (!flat) continue;
+                    handled[column] |= bit;
+
+                    // 底面与侧面逐方块剔除后输出
+                    faceIndices.clear();
+                    for (int faceIdx = 0; faceIdx < static_cast<int>(model.faces.size()); ++faceIdx) {
+                        if (faceIdx != 1 && KeepFace(model.faces[faceIdx].faceDirection, neighbors)) {
+                            faceIndices.push_back(faceIdx);
+                        }
+                    }
+                    builder.AppendFaces(model, faceIndices, snapshot.OriginX() + lx, snapshot.OriginY() + ly,
+                        snapshot.OriginZ() + lz, &fluid.materialIds);
+
+                    // 顶面留到整层合并
+                    if (!KeepFace(top.faceDirection, neighbors)) continue;
+                    const uint32_t materialId = fluid.materialIds[top.materialIndex];
+                    const float vTop = model.uvCoordinates[top.uvIndices[0] * 2 + 1];
+                    const float vBottom = model.uvCoordinates[top.uvIndices[2] * 2 + 1];
+                    size_t surface = 0;
+                    while (surface < surfaces.size() &&
+                        !(surfaces[surface].materialId == materialId && surfaces[surface].height == height &&
+                          surfaces[surface].direction == top.faceDirection &&
+                          surfaces[surface].vTop == vTop && surfaces[surface].vBottom == vBottom)) {
+                        ++surface;
+                    }
+                    if (surface == surfaces.size()) {
+                        if (surfaces.size() == 255) {
+                            // 分组用尽(实际不会出现)时直接按单个方块输出
+                            builder.AppendFaces(model, { 1 }, snapshot.OriginX() + lx, snapshot.OriginY() + ly,
+                                snapshot.OriginZ() + lz, &fluid.materialIds);
+                            continue;
+                        }
+                        surfaces.push_back({ materialId, height, top.faceDirection, vTop, vBottom,
+                            vTop - vBottom == 1.0f });
+                    }
+                    topMask[ly][column] = static_cast<uint8_t>(surface + 1);
+                }
+            }
+        }
+        if (surfaces.empty()) return;
+
+        // 逐层贪心合并顶面:先沿 X 延伸,再沿 Z 扩展整行
+        for (int ly = lyBegin; ly <= lyEnd; ++ly) {
+            auto& mask = topMask[ly];
+            for (int lz = 0; lz < 16; ++lz) {
+                for (int lx = 0; lx < 16; ++lx) {
+                    const uint8_t key = mask[SectionFaceMasks::Column(lx, lz)];
+                    if (key == 0) continue;
+                    const TopSurface& surface = surfaces[key - 1];
+
+                    int w = 1;
+                    while (lx + w < 16 && mask[SectionFaceMasks::Column(lx + w, lz)] == key) {
+                        ++w;
+                    }
+                    int d = 1;
+                    while (surface.singleFrame && lz + d < 16) {
+                        bool rowMatches = true;
+                        for (int i = 0; i < w && rowMatches; ++i) {
+                            rowMatches = mask[SectionFaceMasks::Column(lx + i, lz + d)] == key;
+                        }
+                        if (!rowMatches) break;
+                        ++d;
+                    }
+                    for (int j = 0; j < d; ++j) {
+                        for (int i = 0; i < w; ++i) {
+                            mask[SectionFaceMasks::Column(lx + i, lz + j)] = 0;
+                        }
+                    }
+
+                    // 顶点顺序与流体模型的顶面相同(西北、西南、东南、东北),U 沿 X、V 沿 Z 平铺
+                    const float x0 = static_cast<float>(snapshot.OriginX() + lx);
+                    const float x1 = x0 + w;
+                    const float z0 = static_cast<float>(snapshot.OriginZ() + lz);
+                    const float z1 = z0 + d;
+                    const float y = snapshot.OriginY() + ly + surface.height;
+                    const float vEnd = surface.vTop - d * (surface.vTop - surface.vBottom);
+                    builder.AppendQuad(
+                        { x0, y, z0,   x0, y, z1,   x1, y, z1,   x1, y, z0 },
+                        { 0.0f, surface.vTop,   0.0f, vEnd,   static_cast<float>(w), vEnd,   static_cast<float>(w), surface.vTop },
+                        surface.materialId, surface.direction);
+                }
+            }
+        }
+    }
+
+}
@@ -0,0 +1,22 @@
+// FluidSurfaceMesher.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include "MeshBuilder.h"
+#include "SectionSnapshot.h"
+
+// 子区块流体表面网格生成
+// 按子区块的流体液位处理顶面平坦的纯流体方块(水源、被流体覆盖的流体等):
+//   - 同一层中高度、材质相同且顶面可见的方块合并为一个顶面四边形(只有 V 范围为 1 的单帧纹理沿 Z 方向合并,其余只沿 X 方向合并,保持 V 坐标在一帧内);
+//   - 底面与侧面按与逐方块相同的规则剔除流体-流体、流体-固体的接触面,只输出剩余的面;
+//   - 含水方块、顶面倾斜或流动的流体仍由 ChunkGenerator 逐方块生成。
+namespace FluidSurfaceMesher {
+
+    // 处理子区块内 [lxBegin, lxEnd] x [lyBegin, lyEnd] x [lzBegin, lzEnd] 中的流体
+    // handled[SectionFaceMasks::Column(lx, lz)] 的第 ly 位表示该方块已处理(已输出或被过滤),调用方不需要再逐方块生成
+    void MeshSection(MeshBuilder& builder, const SectionSnapshot& snapshot, const SectionFaceMasks& masks,
+        int lxBegin, int lxEnd, int lyBegin, int lyEnd, int lzBegin, int lzEnd,
+        std::array<uint16_t, 256>& handled);
+
+}
@@ -7,6 +7,7 @@
 #include "biome.h"
 #include "Fluid.h"
 #include "texture.h"
+#include "BakedModel.h"
 #include <iomanip>
 #include <sstream>
 #include <regex>
@@ -82,24 +83,19 @@ std::string getExecutablePathForTexture() {
     }
 }
 
-std::string GetBlockAverageColor(int blockId, Block currentBlock, int x, int y, int z, const std::string& faceDirection, float gamma = 2.0) {
+std::string GetBlockAverageColor(int blockId, int x, int y, int z, const std::string& faceDirection, float gamma = 2.0) {
 
-    Block b = GetBlockById(blockId);
-    std::string blockName = b.GetModifiedNameWithNamespace();
-    std::string ns = b.GetNamespace();
-
-    size_t colonPos = blockName.find(':');
-    if (colonPos != std::string::npos) {
-        blockName = blockName.substr(colonPos + 1);
-    }
-    ModelData blockModel;
-    bool isFluid = (fluidDefinitions.find(currentBlock.GetNameAndNameSpaceWithoutState()) != fluidDefinitions.end());
-    if (isFluid && currentBlock.level > -1) {
-        AssignFluidMaterials(blockModel, currentBlock.name);
+    ModelData fluidModel;
+    const ModelData* modelPtr;
+    bool isFluid = blockTraits.IsFluid(blockId);
+    if (isFluid && blockTraits.Level(blockId) > -1) {
+        fluidModel.materials = fluidModels.Materials(blockTraits.FluidId(blockId));
+        modelPtr = &fluidModel;
     }
     else {
-        blockModel = GetRandomModelFromCache(ns, blockName);
+        modelPtr = &bakedModels.Select(blockId);
     }
+    const ModelData& blockModel = *modelPtr;
     std::string cacheKey = std::to_string(blockId) + ":" + faceDirection;
     std::string textureAverage;
 
@@ -231,7 +227,7 @@ std::string GetBlockAverageColor(int blockId, Block currentBlock, int x, int y,
         std::ostringstream oss;
         oss << std::fixed << std::setprecision(config.decimalPlaces);
         if (isFluid) {
-            oss << "color#" << finalR << " " << finalG << " " << finalB << "-" << currentBlock.GetNameAndNameSpaceWithoutState().c_str();
+            oss << "color#" << finalR << " " << finalG << " " << finalB << "-" << blockTraits.BaseName(blockId);
         }
         else {
             oss << "color#" << finalR << " " << finalG << " " << finalB << "=";
@@ -240,7 +236,7 @@ std::string GetBlockAverageColor(int blockId, Block currentBlock, int x, int y,
     }
     else {
         if (isFluid) {
-            return  + "color#" + textureAverage + "-" + currentBlock.GetNameAndNameSpaceWithoutState();
+            return  + "color#" + textureAverage + "-" + blockTraits.BaseName(blockId);
         }
         else {
             return "color#" + textureAverage + "=";
@@ -253,6 +249,8 @@ float LODManager::GetChunkLODAtBlock(int x, int y, int z) {
     blockToChunk(x, z, chunkX, chunkZ);
     blockYToSectionY(y, sectionY);
     auto key = std::make_tuple(chunkX, sectionY, chunkZ);
+    // 卸载可能与网格生成同时进行,读取时加共享锁
+    std::shared_lock<std::shared_mutex> lock(g_chunkSectionInfoMapMutex);
     auto it = g_chunkSectionInfoMap.find(key);
     if (it != g_chunkSectionInfoMap.end()) {
         return it->second.lodLevel;
@@ -262,12 +260,11 @@ float LODManager::GetChunkLODAtBlock(int x, int y, int z) {
 
 BlockType GetBlockType(int x, int y, int z) {
     int currentId = GetBlockId(x, y, z);
-    Block currentBlock = GetBlockById(currentId);
 
-    if (currentBlock.name == "minecraft:air") {
+    if (blockTraits.IsAir(currentId)) {
         return AIR;
     }
-    else if (currentBlock.level > -1) {
+    else if (blockTraits.Level(currentId) > -1) {
         return FLUID;
     }
     else {
@@ -277,12 +274,12 @@ BlockType GetBlockType(int x, int y, int z) {
 
 BlockType GetBlockType2(int x, int y, int z) {
     int currentId = GetBlockId(x, y, z);
-    Block currentBlock = GetBlockById(currentId);
+    int level = blockTraits.Level(currentId);
 
-    if (!currentBlock.air && currentBlock.level == -1) {
+    if (blockTraits.IsSolid(currentId) && level == -1) {
         return SOLID;
     }
-    else if (currentBlock.level > -1) {
+    else if (level > -1) {
         return FLUID;
     }
     else
@@ -402,14 +399,12 @@ BlockType LODManager::DetermineLODBlockTypeWithUpperCheck(int x, int y, int z, i
 }
 
 std::vector<std::string> LODManager::GetBlockColor(int x, int y, int z, int id, BlockType blockType) {
-    Block currentBlock = GetBlockById(id);
-
     if (blockType == FLUID) {
-        return {GetBlockAverageColor(id, currentBlock, x, y, z, "none") };
+        return {GetBlockAverageColor(id, x, y, z, "none") };
     }
     else {
-        std::string upColor = GetBlockAverageColor(id, currentBlock, x, y, z, "up");
-        std::string northColor = GetBlockAverageColor(id, currentBlock, x, y, z, "north");
+        std::string upColor = GetBlockAverageColor(id, x, y, z, "up");
+        std::string northColor = GetBlockAverageColor(id, x, y, z, "north");
         return { upColor,northColor };  // 使用不同的颜色组合
     }
 }
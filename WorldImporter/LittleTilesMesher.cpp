@@ -0,0 +1,322 @@
+// LittleTilesMesher.cpp
+#include "LittleTilesMesher.h"
+#include "GlobalCache.h"
+#include "blockstate.h"
+#include <algorithm>
+#include <array>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+    // 体素数超过该值时不再栅格化,逐个 box 输出未被覆盖的面
+    constexpr long long kMaxCells = 1LL << 21;
+
+    // 面方向:法线所在轴、正负方向、在 boxData 面状态中的下标
+    struct Direction {
+        FaceType type;
+        int axis;
+        int sign;
+        int stateIndex;
+    };
+
+    constexpr std::array<Direction, 6> kDirections = { {
+        { UP, 1, 1, 0 },
+        { DOWN, 1, -1, 1 },
+        { SOUTH, 2, 1, 2 },
+        { NORTH, 2, -1, 3 },
+        { EAST, 0, 1, 4 },
+        { WEST, 0, -1, 5 },
+    } };
+
+    // 检查面是否被完全覆盖,如果是则应被剔除
+    bool IsFaceCovered(int state) {
+        const auto faceState = static_cast<LittleFaceState>(state);
+        return faceState == LittleFaceState::INSIDE_COVERED || faceState == LittleFaceState::OUTSIDE_COVERED;
+    }
+
+    struct Box {
+        int min[3];
+        int max[3];
+        int tile;
+        const int* states; // boxData 的前 6 个面状态
+    };
+
+    struct TileInfo {
+        int material[6]; // 各方向(kDirections 顺序)在输出模型中的材质下标
+        bool opaque;     // 在 solids 中,遮挡相邻 tile 的面
+    };
+
+    int FloorDiv(int value, int divisor) {
+        return (value >= 0) ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // 按方向追加一个面,顶点顺序和 UV 与原先的 CreateCube 相同(UV 取方块坐标)
+    void AppendBoxFace(ModelData& model, FaceType dir, const float lo[3], const float hi[3], int materialIndex) {
+        const float minX = lo[0], minY = lo[1], minZ = lo[2];
+        const float maxX = hi[0], maxY = hi[1], maxZ = hi[2];
+        std::array<float, 12> v;
+        std::array<float, 8> uv;
+        switch (dir) {
+        case UP:
+            v = { minX, maxY, minZ,   maxX, maxY, minZ,   maxX, maxY, maxZ,   minX, maxY, maxZ };
+            uv = { minX, minZ,   maxX, minZ,   maxX, maxZ,   minX, maxZ };
+            break;
+        case DOWN:
+            v = { minX, minY, maxZ,   maxX, minY, maxZ,   maxX, minY, minZ,   minX, minY, minZ };
+            uv = { minX, maxZ,   maxX, maxZ,   maxX, minZ,   minX, minZ };
+            break;
+        case EAST:
+            v = { maxX, minY, minZ,   maxX, maxY, minZ,   maxX, maxY, maxZ,   maxX, minY, maxZ };
+            uv = { minZ, minY,   minZ, maxY,   maxZ, maxY,   maxZ, minY };
+            break;
+        case WEST:
+            v = { minX, minY, maxZ,   minX, maxY, maxZ,   minX, maxY, minZ,   minX, minY, minZ };
+            uv = { maxZ, minY,   maxZ, maxY,   minZ, maxY,   minZ, minY };
+            break;
+        case NORTH:
+            v = { minX, minY, minZ,   maxX, minY, minZ,   maxX, maxY, minZ,   minX, maxY, minZ };
+            uv = { minX, minY,   maxX, minY,   maxX, maxY,   minX, maxY };
+            break;
+        case SOUTH:
+            v = { maxX, minY, maxZ,   minX, minY, maxZ,   minX, maxY, maxZ,   maxX, maxY, maxZ };
+            uv = { maxX, minY,   minX, minY,   minX, maxY,   maxX, maxY };
+            break;
+        default:
+            return;
+        }
+
+        const int vertexBase = static_cast<int>(model.vertices.size() / 3);
+        const int uvBase = static_cast<int>(model.uvCoordinates.size() / 2);
+        model.vertices.insert(model.vertices.end(), v.begin(), v.end());
+        model.uvCoordinates.insert(model.uvCoordinates.end(), uv.begin(), uv.end());
+        model.faces.push_back({ { vertexBase, vertexBase + 1, vertexBase + 2, vertexBase + 3 },
+            { uvBase, uvBase + 1, uvBase + 2, uvBase + 3 }, materialIndex, dir });
+    }
+
+    // 在模板模型中为各方向挑选材质(与原先 CreateCube 的规则相同),并登记到输出模型的材质表
+    TileInfo ResolveTile(const std::string& fullBlockName, ModelData& model,
+        std::unordered_map<std::string, int>& materialByName) {
+        std::string ns = "minecraft"; // 默认命名空间
+        std::string blockName;
+        size_t colonPos = fullBlockName.find(':');
+        if (colonPos != std::string::npos) {
+            ns = fullBlockName.substr(0, colonPos);
+            blockName = fullBlockName.substr(colonPos + 1);
+        }
+        else {
+            blockName = fullBlockName;
+        }
+
+        ModelData templateModel = GetRandomModelFromCache(ns, blockName);
+        if (templateModel.vertices.empty() && !blockName.empty()) {
+            ProcessBlockstate(ns, { blockName });
+            templateModel = GetRandomModelFromCache(ns, blockName);
+        }
+
+        if (templateModel.materials.empty()) {
+            // 如果没有材质,创建一个虚拟材质以防止崩溃
+            Material dummyMaterial;
+            dummyMaterial.name = "dummy";
+            dummyMaterial.texturePath = "None";
+            templateModel.materials.push_back(dummyMaterial);
+        }
+
+        // 面-材质映射
+        std::map<FaceType, int> faceMaterialMap;
+        int anySideMaterial = -1;
+        for (const auto& face : templateModel.faces) {
+            if (faceMaterialMap.find(face.faceDirection) == faceMaterialMap.end()) {
+                faceMaterialMap[face.faceDirection] = face.materialIndex;
+            }
+            if (anySideMaterial == -1 && (face.faceDirection == NORTH || face.faceDirection == SOUTH || face.faceDirection == EAST || face.faceDirection == WEST)) {
+                anySideMaterial = face.materialIndex;
+            }
+        }
+
+        auto getMaterialForFace = [&](FaceType dir) -> int {
+            auto it = faceMaterialMap.find(dir);
+            if (it != faceMaterialMap.end()) {
+                return it->second;
+            }
+            // 侧面的备用方案
+            if (dir == NORTH || dir == SOUTH || dir == EAST || dir == WEST) {
+                if (anySideMaterial != -1) return anySideMaterial;
+            }
+            // 顶部/底部的备用方案
+            auto it_up = faceMaterialMap.find(UP);
+            if (it_up != faceMaterialMap.end()) return it_up->second;
+            auto it_down = faceMaterialMap.find(DOWN);
+            if (it_down != faceMaterialMap.end()) return it_down->second;
+
+            if (anySideMaterial != -1) return anySideMaterial; // 再次尝试侧面
+            if (!faceMaterialMap.empty()) return faceMaterialMap.begin()->second; // 尝试任何一个
+            return 0; // 最后手段
+        };
+
+        TileInfo info;
+        for (size_t d = 0; d < kDirections.size(); ++d) {
+            int local = getMaterialForFace(kDirections[d].type);
+            if (local < 0 || local >= static_cast<int>(templateModel.materials.size())) {
+                local = 0;
+            }
+            // 同名材质只登记一次,不同 tile 使用相同纹理时可以合并
+            const Material& material = templateModel.materials[local];
+            auto [it, inserted] = materialByName.try_emplace(material.name, static_cast<int>(model.materials.size()));
+            if (inserted) {
+                model.materials.push_back(material);
+            }
+            info.material[d] = it->second;
+        }
+
+        const size_t bracketPos = fullBlockName.find('[');
+        std::string baseName = fullBlockName.substr(0, bracketPos);
+        if (baseName.find(':') == std::string::npos) {
+            baseName = "minecraft:" + baseName;
+        }
+        info.opaque = solidBlocks.count(baseName) != 0;
+        return info;
+    }
+
+} // namespace
+
+namespace LittleTilesMesher {
+
+    ModelData Mesh(const std::vector<LittleTilesTileEntry>& tiles, int grid) {
+        ModelData model;
+        if (grid <= 0) return model;
+        const float gridF = static_cast<float>(grid);
+
+        std::vector<TileInfo> tileInfos;
+        std::vector<Box> boxes;
+        std::unordered_map<std::string, int> materialByName;
+        for (const auto& tile : tiles) {
+            const int tileIndex = static_cast<int>(tileInfos.size());
+            tileInfos.push_back(ResolveTile(tile.blockName, model, materialByName));
+            for (const auto& boxData : tile.boxDataList) {
+                if (boxData.size() != 12) continue; // 前6个为面状态,后6个为边界
+                Box box{ { boxData[6], boxData[7], boxData[8] }, { boxData[9], boxData[10], boxData[11] }, tileIndex, boxData.data() };
+                if (box.min[0] >= box.max[0] || box.min[1] >= box.max[1] || box.min[2] >= box.max[2]) continue;
+                boxes.push_back(box);
+            }
+        }
+        if (boxes.empty()) return model;
+
+        // 所有 box 的包围盒(grid 单位)
+        int lo[3] = { boxes[0].min[0], boxes[0].min[1], boxes[0].min[2] };
+        int hi[3] = { boxes[0].max[0], boxes[0].max[1], boxes[0].max[2] };
+        for (const auto& box : boxes) {
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = (std::min)(lo[a], box.min[a]);
+                hi[a] = (std::max)(hi[a], box.max[a]);
+            }
+        }
+        const int size[3] = { hi[0] - lo[0], hi[1] - lo[1], hi[2] - lo[2] };
+        const long long volume = static_cast<long long>(size[0]) * size[1] * size[2];
+
+        if (volume > kMaxCells) {
+            // 范围过大时逐个 box 输出,只按面状态剔除
+            for (const auto& box : boxes) {
+                const float boxLo[3] = { box.min[0] / gridF, box.min[1] / gridF, box.min[2] / gridF };
+                const float boxHi[3] = { box.max[0] / gridF, box.max[1] / gridF, box.max[2] / gridF };
+                for (size_t d = 0; d < kDirections.size(); ++d) {
+                    if (IsFaceCovered(box.states[kDirections[d].stateIndex])) continue;
+                    AppendBoxFace(model, kDirections[d].type, boxLo, boxHi, tileInfos[box.tile].material[d]);
+                }
+            }
+            return model;
+        }
+
+        // 栅格化:每个体素记录覆盖它的 box(重叠时后出现的 box 优先)
+        std::vector<int> cells(static_cast<size_t>(volume), -1);
+        auto cellIndex = [&](const int c[3]) {
+            return (static_cast<size_t>(c[1]) * size[2] + c[2]) * size[0] + c[0];
+        };
+        for (int b = 0; b < static_cast<int>(boxes.size()); ++b) {
+            const Box& box = boxes[b];
+            int c[3];
+            for (c[1] = box.min[1] - lo[1]; c[1] < box.max[1] - lo[1]; ++c[1]) {
+                for (c[2] = box.min[2] - lo[2]; c[2] < box.max[2] - lo[2]; ++c[2]) {
+                    for (c[0] = box.min[0] - lo[0]; c[0] < box.max[0] - lo[0]; ++c[0]) {
+                        cells[cellIndex(c)] = b;
+                    }
+                }
+            }
+        }
+
+        // 两个体素坐标是否在同一个方块内(合并的面不跨方块,保持纹理按方块平铺)
+        auto sameBlock = [&](int axis, int i, int j) {
+            return FloorDiv(i + lo[axis], grid) == FloorDiv(j + lo[axis], grid);
+        };
+
+        std::vector<int> mask;
+        for (size_t d = 0; d < kDirections.size(); ++d) {
+            const Direction& dir = kDirections[d];
+            const int n = dir.axis;
+            const int u = (n + 1) % 3;
+            const int v = (n + 2) % 3;
+            mask.assign(static_cast<size_t>(size[u]) * size[v], 0);
+
+            for (int k = 0; k < size[n]; ++k) {
+                // 该层每个体素在此方向上的面:0 表示无面,否则为材质下标 + 1
+                for (int b = 0; b < size[v]; ++b) {
+                    for (int a = 0; a < size[u]; ++a) {
+                        int c[3];
+                        c[n] = k; c[u] = a; c[v] = b;
+                        int& key = mask[static_cast<size_t>(b) * size[u] + a];
+                        key = 0;
+                        const int self = cells[cellIndex(c)];
+                        if (self < 0) continue;
+
+                        c[n] = k + dir.sign;
+                        const int neighbor = (c[n] >= 0 && c[n] < size[n]) ? cells[cellIndex(c)] : -1;
+                        if (neighbor == self) continue;
+                        const Box& box = boxes[self];
+                        if (neighbor >= 0) {
+                            const int neighborTile = boxes[neighbor].tile;
+                            if (neighborTile == box.tile || tileInfos[neighborTile].opaque) continue;
+                        }
+                        if (IsFaceCovered(box.states[dir.stateIndex])) continue;
+                        key = tileInfos[box.tile].material[d] + 1;
+                    }
+                }
+
+                // 贪心合并材质相同的相邻面
+                for (int b = 0; b < size[v]; ++b) {
+                    for (int a = 0; a < size[u]; ++a) {
+                        const int key = mask[static_cast<size_t>(b) * size[u] + a];
+                        if (key == 0) continue;
+
+                        int w = 1;
+                        while (a + w < size[u] && sameBlock(u, a, a + w) &&
+                            mask[static_cast<size_t>(b) * size[u] + a + w] == key) {
+                            ++w;
+                        }
+                        int h = 1;
+                        while (b + h < size[v] && sameBlock(v, b, b + h)) {
+                            const int* row = &mask[static_cast<size_t>(b + h) * size[u] + a];
+                            if (!std::all_of(row, row + w, [key](int value) { return value == key; })) break;
+                            ++h;
+                        }
+                        for (int y = 0; y < h; ++y) {
+                            std::fill_n(&mask[static_cast<size_t>(b + y) * size[u] + a], w, 0);
+                        }
+
+                        int faceLo[3], faceHi[3];
+                        faceLo[n] = faceHi[n] = lo[n] + k + (dir.sign > 0 ? 1 : 0);
+                        faceLo[u] = lo[u] + a;
+                        faceHi[u] = lo[u] + a + w;
+                        faceLo[v] = lo[v] + b;
+                        faceHi[v] = lo[v] + b + h;
+                        const float quadLo[3] = { faceLo[0] / gridF, faceLo[1] / gridF, faceLo[2] / gridF };
+                        const float quadHi[3] = { faceHi[0] / gridF, faceHi[1] / gridF, faceHi[2] / gridF };
+                        AppendBoxFace(model, dir.type, quadLo, quadHi, key - 1);
+                    }
+                }
+            }
+        }
+        return model;
+    }
+
+}
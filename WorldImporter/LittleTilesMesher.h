@@ -0,0 +1,18 @@
+// LittleTilesMesher.h
+#pragma once
+
+#include <vector>
+#include "EntityBlock.h"
+#include "model.h"
+
+// LittleTiles 的 tile 网格生成器
+// 把一组 tiles 的所有 box 栅格化到 grid 精度的体素上,按方向逐层生成面:
+//   - 相邻体素属于同一 tile 或不透明 tile(solids 中的方块)时剔除两者之间的面;
+//   - box 面状态为 COVERED 的外表面与原先一样剔除;
+//   - 同一层内材质相同的面在每个方块范围内贪心合并为一个四边形。
+// 所有面直接写入同一个 ModelData,不再为每个 box 生成立方体再逐个合并。坐标以方块为单位,不含实体方块的位置偏移。
+namespace LittleTilesMesher {
+
+    ModelData Mesh(const std::vector<LittleTilesTileEntry>& tiles, int grid);
+
+}
@@ -0,0 +1,27 @@
+// MaterialRegistry.cpp
+#include "MaterialRegistry.h"
+#include <iostream>
+
+MaterialRegistry materialRegistry;
+
+uint32_t MaterialRegistry::Intern(const Material& material) {
+    std::optional<uint32_t> id = m_materials.Intern(material.name, nullptr, [](uint32_t, const Material&) {}, material);
+    if (!id) {
+        std::cerr << "全局材质表已满,使用第一个材质: " << material.name << std::endl;
+        return 0;
+    }
+    return *id;
+}
+
+void MaterialRegistry::InternAll(const std::vector<Material>& materials, std::vector<uint32_t>& ids) {
+    ids.resize(materials.size());
+    for (size_t i = 0; i < materials.size(); ++i) {
+        ids[i] = Intern(materials[i]);
+    }
+}
+
+const Material& MaterialRegistry::Get(uint32_t id) const {
+    static const Material empty;
+    const Material* material = m_materials.Find(id);
+    return material ? *material : empty;
+}
@@ -0,0 +1,36 @@
+// MaterialRegistry.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "ShardedInterner.h"
+#include "model.h"
+
+// 全局材质表:材质名 -> 稳定的全局材质ID
+// 方块模型、流体、LOD 纯色材质在进入导出网格时登记一次,之后导出网格(MeshBuilder 的结果)中
+// Face::materialIndex 都是这里的ID,合并网格只需追加,去重与 OBJ/MTL 写出按ID查表,不再比较材质名。
+// 与 MergeModelsDirectly 的约定一致,同名材质以第一次登记的为准。
+// 与 BlockStateInterner 一样由 ShardedInterner 按名称分片查找,按ID读取无需加锁。
+class MaterialRegistry {
+public:
+    static constexpr size_t kMaxMaterials = 1024 * 1024;
+
+    // 返回材质名对应的ID,不存在时登记;超过上限时返回 0
+    uint32_t Intern(const Material& material);
+
+    // 依次登记 materials,ids[i] 为 materials[i] 的全局ID
+    void InternAll(const std::vector<Material>& materials, std::vector<uint32_t>& ids);
+
+    // 按ID读取材质;无效ID返回空材质
+    const Material& Get(uint32_t id) const;
+
+    // 已登记的材质数,ID 为 [0, Size())
+    size_t Size() const { return m_materials.Size(); }
+
+private:
+    ShardedInterner<Material, kMaxMaterials> m_materials;
+};
+
+// 全局材质表
+extern MaterialRegistry materialRegistry;
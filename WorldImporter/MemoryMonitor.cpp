@@ -74,11 +74,10 @@ size_t estimate_vector_memory(const std::vector<T>& vec) {
 // 辅助函数，估算 SectionCacheEntry 的深层内存占用
 size_t estimate_section_cache_entry_memory(const SectionCacheEntry& entry) {
     size_t memory = sizeof(SectionCacheEntry);
-    memory += estimate_vector_memory(entry.skyLight);
-    memory += estimate_vector_memory(entry.blockLight);
+    memory += estimate_vector_memory(entry.skyLight.nibbles);
+    memory += estimate_vector_memory(entry.blockLight.nibbles);
     memory += estimate_vector_memory(entry.blockData);
     memory += estimate_vector_memory(entry.biomeData);
-    memory += estimate_vector_memory(entry.blockPalette); // vector<string>
     return memory;
 }
 
@@ -95,12 +94,8 @@ size_t estimate_unordered_map_memory(const std::unordered_map<K, V, Hash>& map)
         if constexpr (std::is_same_v<K, std::string>) {
             memory += pair.first.capacity();
         }
-        // 对于 SectionCacheEntry
-        if constexpr (std::is_same_v<V, SectionCacheEntry>) {
-            memory += estimate_section_cache_entry_memory(pair.second);
-        }
         // 对于 vector<shared_ptr<EntityBlock>>
-        else if constexpr (std::is_same_v<V, std::vector<std::shared_ptr<EntityBlock>>>) {
+        if constexpr (std::is_same_v<V, std::vector<std::shared_ptr<EntityBlock>>>) {
             memory += estimate_vector_memory(pair.second);
         }
         // 对于 unordered_map<string, vector<int>>
@@ -124,12 +119,9 @@ static std::atomic<bool> monitoring_active = false;
 static std::thread monitor_thread;
 
 void MonitorTask(
-    const SectionCacheType* sectionCache,
-    std::shared_mutex* sectionCacheMutex,
+    const SectionGrid* sectionGrid,
     const EntityBlockCacheType* entityBlockCache,
-    std::shared_mutex* entityBlockCacheMutex,
-    const HeightMapCacheType* heightMapCache,
-    std::shared_mutex* heightMapCacheMutex
+    std::shared_mutex* entityBlockCacheMutex
 ) {
     while (monitoring_active) {
         std::this_thread::sleep_for(std::chrono::seconds(10));
@@ -137,20 +129,21 @@ void MonitorTask(
 
         size_t section_cache_size_bytes = 0;
         size_t entity_block_cache_size_bytes = 0;
-        size_t height_map_cache_size_bytes = 0;
+        size_t height_map_cache_size_bytes = 0; // 高度图保存在 ChunkColumn 中
 
-        {
-            std::shared_lock<std::shared_mutex> lock(*sectionCacheMutex);
-            section_cache_size_bytes = estimate_unordered_map_memory(*sectionCache);
-        }
+        sectionGrid->ForEachColumn([&](int, int, const ChunkColumn& column) {
+            section_cache_size_bytes += sizeof(ChunkColumn) + sizeof(std::pair<int, int>);
+            for (const auto& entry : column.sections) {
+                section_cache_size_bytes += estimate_section_cache_entry_memory(entry);
+            }
+            for (const auto& heights : column.heightMaps) {
+                height_map_cache_size_bytes += estimate_vector_memory(heights);
+            }
+        });
         {
             std::shared_lock<std::shared_mutex> lock(*entityBlockCacheMutex);
             entity_block_cache_size_bytes = estimate_unordered_map_memory(*entityBlockCache);
         }
-        {
-            std::shared_lock<std::shared_mutex> lock(*heightMapCacheMutex);
-            height_map_cache_size_bytes = estimate_unordered_map_memory(*heightMapCache);
-        }
 
         std::cout << "--- Memory Usage --- (Approximate)" << std::endl;
         std::cout << "sectionCache:     " << section_cache_size_bytes / 1024.0 / 1024.0 << " MB" << std::endl;
@@ -161,19 +154,16 @@ void MonitorTask(
 }
 
 void StartMonitoring(
-    const SectionCacheType& sectionCache,
-    std::shared_mutex& sectionCacheMutexRef,
+    const SectionGrid& sectionGrid,
     const EntityBlockCacheType& entityBlockCache,
-    std::shared_mutex& entityBlockCacheMutexRef,
-    const HeightMapCacheType& heightMapCache,
-    std::shared_mutex& heightMapCacheMutexRef
+    std::shared_mutex& entityBlockCacheMutexRef
 ) {
     if (monitoring_active) {
         return; // 已经在监控
     }
     monitoring_active = true;
     // 传递指针和引用给线程函数
-    monitor_thread = std::thread(MonitorTask, &sectionCache, &sectionCacheMutexRef, &entityBlockCache, &entityBlockCacheMutexRef, &heightMapCache, &heightMapCacheMutexRef);
+    monitor_thread = std::thread(MonitorTask, &sectionGrid, &entityBlockCache, &entityBlockCacheMutexRef);
     std::cout << "Memory monitoring started." << std::endl;
 }
 
@@ -0,0 +1,146 @@
+// MeshBuilder.cpp
+#include "MeshBuilder.h"
+#include "MaterialRegistry.h"
+
+MeshBuilder& MeshBuilder::ForThread() {
+    thread_local MeshBuilder builder;
+    return builder;
+}
+
+void MeshBuilder::Reset() {
+    m_mesh.vertices.clear();
+    m_mesh.uvCoordinates.clear();
+    m_mesh.faces.clear();
+    m_mesh.materials.clear();
+}
+
+void MeshBuilder::AppendFace(const Face& face, int vertexOffset, int uvOffset, const std::vector<uint32_t>& materialIds) {
+    Face newFace;
+    for (int j = 0; j < 4; ++j) {
+        newFace.vertexIndices[j] = face.vertexIndices[j] + vertexOffset;
+        newFace.uvIndices[j] = face.uvIndices[j] + uvOffset;
+    }
+    // 与 MergeModelsDirectly 相同:无效的材质索引使用第一个材质
+    if (face.materialIndex >= 0 && face.materialIndex < static_cast<int>(materialIds.size())) {
+        newFace.materialIndex = static_cast<int>(materialIds[face.materialIndex]);
+    }
+    else {
+        newFace.materialIndex = materialIds.empty() ? -1 : static_cast<int>(materialIds[0]);
+    }
+    newFace.faceDirection = face.faceDirection;
+    m_mesh.faces.push_back(newFace);
+}
+
+void MeshBuilder::Append(const ModelData& model) {
+    const int vertexOffset = static_cast<int>(m_mesh.vertices.size() / 3);
+    const int uvOffset = static_cast<int>(m_mesh.uvCoordinates.size() / 2);
+    materialRegistry.InternAll(model.materials, m_materialIds);
+
+    m_mesh.vertices.insert(m_mesh.vertices.end(), model.vertices.begin(), model.vertices.end());
+    m_mesh.uvCoordinates.insert(m_mesh.uvCoordinates.end(), model.uvCoordinates.begin(), model.uvCoordinates.end());
+    for (const auto& face : model.faces) {
+        AppendFace(face, vertexOffset, uvOffset, m_materialIds);
+    }
+}
+
+void MeshBuilder::AppendFaces(const ModelData& model, const std::vector<int>& faceIndices, int x, int y, int z,
+    const std::vector<uint32_t>* materialIds) {
+    if (faceIndices.empty()) return;
+
+    const int vertexOffset = static_cast<int>(m_mesh.vertices.size() / 3);
+    const int uvOffset = static_cast<int>(m_mesh.uvCoordinates.size() / 2);
+    if (!materialIds) {
+        materialRegistry.InternAll(model.materials, m_materialIds);
+        materialIds = &m_materialIds;
+    }
+
+    // 顶点和UV整体复制(后续去重会合并),坐标在复制时直接偏移到世界坐标
+    const size_t vertexBase = m_mesh.vertices.size();
+    m_mesh.vertices.resize(vertexBase + model.vertices.size());
+    for (size_t i = 0; i + 2 < model.vertices.size(); i += 3) {
+        m_mesh.vertices[vertexBase + i] = model.vertices[i] + x;
+        m_mesh.vertices[vertexBase + i + 1] = model.vertices[i + 1] + y;
+        m_mesh.vertices[vertexBase + i + 2] = model.vertices[i + 2] + z;
+    }
+    m_mesh.uvCoordinates.insert(m_mesh.uvCoordinates.end(), model.uvCoordinates.begin(), model.uvCoordinates.end());
+
+    for (int faceIdx : faceIndices) {
+        AppendFace(model.faces[faceIdx], vertexOffset, uvOffset, *materialIds);
+    }
+}
+
+void MeshBuilder::AppendInstance(const ModelData& model, double x, double y, double z,
+    const std::vector<uint32_t>* materialIds) {
+    const int vertexOffset = static_cast<int>(m_mesh.vertices.size() / 3);
+    const int uvOffset = static_cast<int>(m_mesh.uvCoordinates.size() / 2);
+    if (!materialIds) {
+        materialRegistry.InternAll(model.materials, m_materialIds);
+        materialIds = &m_materialIds;
+    }
+
+    // 与 ApplyDoublePositionOffset 相同,按 double 计算后再存为 float
+    const size_t vertexBase = m_mesh.vertices.size();
+    m_mesh.vertices.resize(vertexBase + model.vertices.size());
+    for (size_t i = 0; i + 2 < model.vertices.size(); i += 3) {
+        m_mesh.vertices[vertexBase + i] = static_cast<float>(model.vertices[i] + x);
+        m_mesh.vertices[vertexBase + i + 1] = static_cast<float>(model.vertices[i + 1] + y);
+        m_mesh.vertices[vertexBase + i + 2] = static_cast<float>(model.vertices[i + 2] + z);
+    }
+    m_mesh.uvCoordinates.insert(m_mesh.uvCoordinates.end(), model.uvCoordinates.begin(), model.uvCoordinates.end());
+
+    for (const auto& face : model.faces) {
+        AppendFace(face, vertexOffset, uvOffset, *materialIds);
+    }
+}
+
+void MeshBuilder::AppendQuad(const std::array<float, 12>& vertices, const std::array<float, 8>& uvs, uint32_t materialId,
+    FaceType direction) {
+    const int vertexOffset = static_cast<int>(m_mesh.vertices.size() / 3);
+    const int uvOffset = static_cast<int>(m_mesh.uvCoordinates.size() / 2);
+    m_mesh.vertices.insert(m_mesh.vertices.end(), vertices.begin(), vertices.end());
+    m_mesh.uvCoordinates.insert(m_mesh.uvCoordinates.end(), uvs.begin(), uvs.end());
+
+    Face face;
+    for (int j = 0; j < 4; ++j) {
+        face.vertexIndices[j] = vertexOffset + j;
+        face.uvIndices[j] = uvOffset + j;
+    }
+    face.materialIndex = static_cast<int>(materialId);
+    face.faceDirection = direction;
+    m_mesh.faces.push_back(face);
+}
+
+void MeshBuilder::AppendMesh(const ModelData& mesh) {
+    const int vertexOffset = static_cast<int>(m_mesh.vertices.size() / 3);
+    const int uvOffset = static_cast<int>(m_mesh.uvCoordinates.size() / 2);
+
+    m_mesh.vertices.insert(m_mesh.vertices.end(), mesh.vertices.begin(), mesh.vertices.end());
+    m_mesh.uvCoordinates.insert(m_mesh.uvCoordinates.end(), mesh.uvCoordinates.begin(), mesh.uvCoordinates.end());
+    for (const auto& face : mesh.faces) {
+        Face newFace = face;
+        for (int j = 0; j < 4; ++j) {
+            newFace.vertexIndices[j] += vertexOffset;
+            newFace.uvIndices[j] += uvOffset;
+        }
+        m_mesh.faces.push_back(newFace);
+    }
+}
+
+ModelData MeshBuilder::Take() {
+    // 移出结果而不复制,再按原有容量为下一组预留缓冲区(只分配,不复制也不清零)
+    const size_t vertexCapacity = m_mesh.vertices.capacity();
+    const size_t uvCapacity = m_mesh.uvCoordinates.capacity();
+    const size_t faceCapacity = m_mesh.faces.capacity();
+    ModelData result = std::move(m_mesh);
+    m_mesh = ModelData();
+    m_mesh.vertices.reserve(vertexCapacity);
+    m_mesh.uvCoordinates.reserve(uvCapacity);
+    m_mesh.faces.reserve(faceCapacity);
+    return result;
+}
+
+ModelData MeshBuilder::Release() {
+    ModelData result = std::move(m_mesh);
+    m_mesh = ModelData();
+    return result;
+}
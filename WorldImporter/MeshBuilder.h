@@ -0,0 +1,54 @@
+// MeshBuilder.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "model.h"
+
+// 网格构建器:按方块追加几何体,替代逐方块调用 MergeModelsDirectly
+// 构建出的导出网格中 Face::materialIndex 为 materialRegistry 中的全局材质ID,materials 为空;
+// 追加的模型使用自己的局部材质表,在追加时映射为全局ID。缓冲区在组与组之间只清空内容而不释放容量。
+// 每个网格线程使用自己的实例(ForThread),因此不需要加锁。
+class MeshBuilder {
+public:
+    // 当前线程的构建器
+    static MeshBuilder& ForThread();
+
+    // 清空已追加的内容,保留已分配的容量
+    void Reset();
+
+    bool Empty() const { return m_mesh.vertices.empty(); }
+
+    // 整体追加一个模型(实体、LOD 方块等已经在世界坐标下的模型)
+    void Append(const ModelData& model);
+
+    // 只追加 model 中 faceIndices 指定的面,顶点在复制时加上 (x, y, z) 偏移
+    // materialIds 为 model 局部材质对应的全局ID(如 BakedModel::materialIds),为空时按材质名登记
+    void AppendFaces(const ModelData& model, const std::vector<int>& faceIndices, int x, int y, int z,
+        const std::vector<uint32_t>* materialIds = nullptr);
+
+    // 整体追加一个模型实例,顶点加上 (x, y, z) 偏移(实体方块的共享子模型等)
+    // materialIds 含义与 AppendFaces 相同
+    void AppendInstance(const ModelData& model, double x, double y, double z,
+        const std::vector<uint32_t>* materialIds = nullptr);
+
+    // 追加一个四边形,顶点为世界坐标,materialId 为全局材质ID(合并后的流体表面等)
+    void AppendQuad(const std::array<float, 12>& vertices, const std::array<float, 8>& uvs, uint32_t materialId,
+        FaceType direction);
+
+    // 追加另一个导出网格(材质已是全局ID),只需偏移索引
+    void AppendMesh(const ModelData& mesh);
+
+    // 移出当前结果,构建器清空并按原容量重新预留缓冲区
+    ModelData Take();
+
+    // 移出当前结果,不保留缓冲区(只构建一次的大网格,如完整导出模型)
+    ModelData Release();
+
+private:
+    void AppendFace(const Face& face, int vertexOffset, int uvOffset, const std::vector<uint32_t>& materialIds);
+
+    ModelData m_mesh;
+    std::vector<uint32_t> m_materialIds;
+};
@@ -11,6 +11,7 @@
 #include <string>
 #include <set>
 #include "TaskMonitor.h"
+#include "MaterialRegistry.h"
 #include <future> // 新增: 用于 std::async, std::future
 #include <mutex>  // 新增: 用于 std::mutex, std::lock_guard
 #include <vector> 
@@ -562,8 +563,9 @@ void ModelDeduplicator::GreedyMesh(ModelData& data) {
     std::vector<UVAxis> faceAxis(faceCount, NONE);
     for (int i = 0; i < (int)faceCount; ++i) {
         const Face& f = data.faces[i];
-        if (f.materialIndex < 0 || (size_t)f.materialIndex >= data.materials.size()) continue;
-        if (data.materials[f.materialIndex].type == ANIMATED) continue;
+        // 导出网格的材质索引为全局材质ID
+        if (f.materialIndex < 0 || (size_t)f.materialIndex >= materialRegistry.Size()) continue;
+        if (materialRegistry.Get(f.materialIndex).type == ANIMATED) continue;
         UVAxis ax = checkUV(i);
         if (ax == NONE) continue;
         eligible[i] = true;
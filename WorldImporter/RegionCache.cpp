@@ -1,103 +1,196 @@
 #include "RegionCache.h"
 #include "fileutils.h"
 #include "config.h"
-#include <sstream>
-#include <fstream>
-#include <filesystem> // 用于检测目录是否存在
+#include "RegionIndex.h"
 #include <cstdint> // 用于 uint8_t, uint32_t
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <array>
 #include "locutil.h"
-std::unordered_map<std::pair<int, int>, std::vector<char>, pair_hash> regionCache(1024);
-
-// 根据配置的选择维度和存档路径，返回对应的 region 目录路径
-static std::string GetRegionDirectory() {
-    const std::string& sel = config.selectedDimension;
-    const std::string& base = config.worldPath;
-    std::string dir;
-    if (sel == "minecraft:overworld") {
-        dir = base + "/region";
-    } else if (sel == "minecraft:the_nether") {
-        dir = base + "/DIM-1/region";
-    } else if (sel == "minecraft:the_end") {
-        dir = base + "/DIM1/region";
-    } else {
-        auto pos = sel.find(':');
-        if (pos == std::string::npos) {
-            dir = base + "/region";
-        } else {
-            std::string ns = sel.substr(0, pos);
-            std::string dimName = sel.substr(pos + 1);
-            dir = base + "/dimensions/" + ns + "/" + dimName + "/region";
-        }
+
+namespace {
+
+    // 分片数量,按区域坐标哈希分散锁竞争
+    constexpr size_t kRegionCacheShards = 16;
+
+    using RegionKey = std::pair<int, int>;
+
+    struct RegionCacheEntry {
+        std::shared_ptr<RegionFile> region;
+        std::list<RegionKey>::iterator lruIt;
+    };
+
+    struct RegionCacheShard {
+        std::mutex mutex;
+        std::unordered_map<RegionKey, RegionCacheEntry, pair_hash> entries; // 只保存映射成功的区域
+        std::list<RegionKey> lru; // 头部为最近使用
+        // 索引中存在但映射失败的区域,避免反复打开并重复报错;数量不超过索引中的区域文件数
+        std::unordered_set<RegionKey, pair_hash> failed;
+    };
+
+    std::array<RegionCacheShard, kRegionCacheShards> regionShards;
+
+    std::atomic<uint64_t> regionCacheHits{ 0 };
+    std::atomic<uint64_t> regionCacheMisses{ 0 };
+    std::atomic<uint64_t> regionCacheEvictions{ 0 };
+    std::atomic<size_t> regionResidentBytes{ 0 };
+
+    std::shared_mutex retainMutex;
+    std::unordered_set<RegionKey, pair_hash> retainedRegions;
+
+    RegionCacheShard& ShardFor(const RegionKey& key) {
+        return regionShards[pair_hash{}(key) % kRegionCacheShards];
     }
-    if (!std::filesystem::exists(dir)) {
-        std::cerr << "警告: 维度目录不存在: " << dir << std::endl;
-        // 回退到主世界 region
-        return base + "/region";
+
+    size_t RegionCacheBudgetBytes() {
+        return static_cast<size_t>(config.regionCacheBudgetMB) * 1024 * 1024;
     }
-    return dir;
-}
 
-//读取.mca文件到内存
-std::vector<char> ReadFileToMemory(const std::string& regionDirPath, int regionX, int regionZ) {
-    // 构造区域文件的路径
-    std::ostringstream filePathStream;
-    filePathStream << regionDirPath << "/r." << regionX << "." << regionZ << ".mca";
-    std::string filePath = filePathStream.str();
-
-    // 打开文件
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file) {
-        std::cerr << "错误: 打开文件失败!" << std::endl;
-        return {};  // 返回空vector表示失败
+    bool IsRetained(const RegionKey& key) {
+        std::shared_lock<std::shared_mutex> lock(retainMutex);
+        return retainedRegions.count(key) != 0;
     }
 
-    // 将文件内容读取到文件数据中
-    std::vector<char> fileData;
-    fileData.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
-    if (fileData.empty()) {
-        std::cerr << "错误: 文件为空或读取失败!" << std::endl;
-        return {};  // 返回空vector表示失败
+    // 从分片的 LRU 尾部淘汰未被保留的区域,直到总量回到预算以内(调用方持有分片锁)
+    void EvictFromShard(RegionCacheShard& shard, const RegionKey* keep) {
+        const size_t budget = RegionCacheBudgetBytes();
+        auto it = shard.lru.end();
+        while (regionResidentBytes.load(std::memory_order_relaxed) > budget && it != shard.lru.begin()) {
+            --it;
+            const RegionKey key = *it;
+            if ((keep && key == *keep) || IsRetained(key)) {
+                continue;
+            }
+            auto entryIt = shard.entries.find(key);
+            if (entryIt != shard.entries.end()) {
+                regionResidentBytes.fetch_sub(entryIt->second.region->Size(), std::memory_order_relaxed);
+                shard.entries.erase(entryIt);
+                regionCacheEvictions.fetch_add(1, std::memory_order_relaxed);
+            }
+            it = shard.lru.erase(it);
+        }
+    }
+
+    // 超出预算时依次在各分片上淘汰
+    void EnforceRegionBudget(RegionCacheShard& current, const RegionKey& keep) {
+        if (regionResidentBytes.load(std::memory_order_relaxed) <= RegionCacheBudgetBytes()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(current.mutex);
+            EvictFromShard(current, &keep);
+        }
+        for (auto& shard : regionShards) {
+            if (regionResidentBytes.load(std::memory_order_relaxed) <= RegionCacheBudgetBytes()) {
+                break;
+            }
+            if (&shard == &current) continue;
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            EvictFromShard(shard, nullptr);
+        }
     }
+}
 
-    // 返回读取到的文件数据
-    return fileData;
+// 映射 .mca 文件,失败时返回 nullptr
+static std::shared_ptr<RegionFile> MapRegionFile(int regionX, int regionZ) {
+    std::string filePath = RegionIndex::GetRegionFilePath(regionX, regionZ);
+    auto region = RegionFile::Open(filePath);
+    if (!region) {
+        std::cerr << "错误: 文件为空或映射失败: " << filePath << std::endl;
+    }
+    return region;
 }
 
 
-const std::vector<char>& GetRegionFromCache(int regionX, int regionZ) {
+std::shared_ptr<RegionFile> GetRegionFromCache(int regionX, int regionZ) {
+    // 通过区域头索引判断文件是否存在,不存在的区域不进入缓存(否则稀疏的世界里空条目会无限增长)
+    if (!RegionIndex::HasRegion(regionX, regionZ)) {
+        return nullptr;
+    }
+
     auto regionKey = std::make_pair(regionX, regionZ);
-    auto it = regionCache.find(regionKey);
-    if (it == regionCache.end()) {
-        std::string regionDir = GetRegionDirectory();
-        std::vector<char> fileData = ReadFileToMemory(regionDir, regionX, regionZ);
-        auto result = regionCache.emplace(regionKey, std::move(fileData));
-        it = result.first;
+    RegionCacheShard& shard = ShardFor(regionKey);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(regionKey);
+        if (it != shard.entries.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruIt);
+            regionCacheHits.fetch_add(1, std::memory_order_relaxed);
+            return it->second.region;
+        }
+        if (shard.failed.count(regionKey)) {
+            return nullptr;
+        }
     }
-    return it->second;
+
+    // 在锁外映射文件,避免阻塞同分片的其他区域
+    regionCacheMisses.fetch_add(1, std::memory_order_relaxed);
+    std::shared_ptr<RegionFile> region = MapRegionFile(regionX, regionZ);
+
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(regionKey);
+        if (it != shard.entries.end()) {
+            // 其他线程已抢先映射,使用已有条目
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruIt);
+            return it->second.region;
+        }
+        if (!region) {
+            shard.failed.insert(regionKey);
+            return nullptr;
+        }
+        shard.lru.push_front(regionKey);
+        shard.entries.emplace(regionKey, RegionCacheEntry{ region, shard.lru.begin() });
+        regionResidentBytes.fetch_add(region->Size(), std::memory_order_relaxed);
+    }
+
+    EnforceRegionBudget(shard, regionKey);
+    return region;
 }
 
-// 新增:判断指定 chunk 是否存在于 region 文件中
-bool HasChunk(int chunkX, int chunkZ) {
-    int regionX, regionZ;
-    chunkToRegion(chunkX, chunkZ, regionX, regionZ);
-    std::string regionDir = GetRegionDirectory();
-    std::ostringstream filePathStream;
-    filePathStream << regionDir << "/r." << regionX << "." << regionZ << ".mca";
-    std::string filePath = filePathStream.str();
-    if (!std::filesystem::exists(filePath)) {
-        return false;
+void SetRegionCacheRetainSet(const std::unordered_set<std::pair<int, int>, pair_hash>& regions) {
+    {
+        std::unique_lock<std::shared_mutex> lock(retainMutex);
+        retainedRegions = regions;
     }
-    const auto& data = GetRegionFromCache(regionX, regionZ);
-    int localX = chunkX - regionX * 32;
-    int localZ = chunkZ - regionZ * 32;
-    if (localX < 0 || localX >= 32 || localZ < 0 || localZ >= 32) {
-        return false;
+    // 保留集合缩小后,之前被保留的区域可能需要淘汰
+    for (auto& shard : regionShards) {
+        if (regionResidentBytes.load(std::memory_order_relaxed) <= RegionCacheBudgetBytes()) {
+            break;
+        }
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        EvictFromShard(shard, nullptr);
     }
-    size_t index = (localX + localZ * 32) * 4;
-    if (data.size() < index + 4) {
-        return false;
+}
+
+RegionCacheStats GetRegionCacheStats() {
+    RegionCacheStats stats;
+    stats.hits = regionCacheHits.load(std::memory_order_relaxed);
+    stats.misses = regionCacheMisses.load(std::memory_order_relaxed);
+    stats.evictions = regionCacheEvictions.load(std::memory_order_relaxed);
+    stats.residentBytes = regionResidentBytes.load(std::memory_order_relaxed);
+    for (auto& shard : regionShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.regionCount += shard.entries.size();
+    }
+    return stats;
+}
+
+void ClearRegionCache() {
+    for (auto& shard : regionShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.lru.clear();
+        shard.failed.clear();
     }
-    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
-    uint32_t offset = ((uint32_t)bytes[index] << 16) | ((uint32_t)bytes[index + 1] << 8) | (uint32_t)bytes[index + 2];
-    return offset != 0;
+    regionResidentBytes.store(0, std::memory_order_relaxed);
+    std::unique_lock<std::shared_mutex> lock(retainMutex);
+    retainedRegions.clear();
+}
+
+// 新增:判断指定 chunk 是否存在于 region 文件中
+bool HasChunk(int chunkX, int chunkZ) {
+    return RegionIndex::HasChunk(chunkX, chunkZ);
 }
\ No newline at end of file
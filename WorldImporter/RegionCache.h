@@ -1,13 +1,36 @@
 #pragma once
 
 #include <unordered_map>
-#include <vector>
+#include <unordered_set>
+#include <memory>
+#include <cstdint>
 #include <utility>
 #include "hashutils.h"
 #include "config.h"
+#include "RegionFile.h"
 
-extern std::unordered_map<std::pair<int, int>, std::vector<char>, pair_hash> regionCache;
-const std::vector<char>& GetRegionFromCache(int regionX, int regionZ);
+// 区域缓存统计信息
+struct RegionCacheStats {
+    uint64_t hits = 0;          // 命中次数
+    uint64_t misses = 0;        // 未命中(需要映射文件)次数
+    uint64_t evictions = 0;     // 因超出预算被淘汰的区域数
+    size_t residentBytes = 0;   // 当前缓存中映射的字节数
+    size_t regionCount = 0;     // 当前缓存的区域数
+};
 
-// 新增:判断指定 chunk 是否存在于 region 文件中
-bool HasChunk(int chunkX, int chunkZ);
\ No newline at end of file
+// 获取(必要时映射)区域文件,区域不存在或映射失败时返回 nullptr
+// 区域缓存按坐标分片加锁,超出 config.regionCacheBudgetMB 时按 LRU 淘汰未被保留的区域
+// 被淘汰的区域仍由调用方持有的 shared_ptr 保持映射,直到最后一个引用释放
+std::shared_ptr<RegionFile> GetRegionFromCache(int regionX, int regionZ);
+
+// 新增:判断指定 chunk 是否存在于 region 文件中(由 RegionIndex 以 O(1) 回答)
+bool HasChunk(int chunkX, int chunkZ);
+
+// 设置需要常驻的区域集合(区域坐标),集合内的区域不会被 LRU 淘汰
+void SetRegionCacheRetainSet(const std::unordered_set<std::pair<int, int>, pair_hash>& regions);
+
+// 获取区域缓存统计信息
+RegionCacheStats GetRegionCacheStats();
+
+// 清空区域缓存(保留集合同时清空),导出结束时释放全部映射
+void ClearRegionCache();
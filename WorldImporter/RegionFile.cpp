@@ -0,0 +1,149 @@
+// RegionFile.cpp
+#include "RegionFile.h"
+#include <iostream>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<RegionFile> RegionFile::Open(const std::string& filePath) {
+    std::shared_ptr<RegionFile> region(new RegionFile());
+    region->m_path = filePath;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+    region->m_fileHandle = file;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        std::cerr << "错误: 无法映射区域文件: " << filePath << std::endl;
+        return nullptr;
+    }
+    region->m_mappingHandle = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        std::cerr << "错误: 无法映射区域文件: " << filePath << std::endl;
+        return nullptr;
+    }
+    region->m_data = static_cast<const char*>(view);
+    region->m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(filePath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    region->m_fd = fd;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        return nullptr;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "错误: 无法映射区域文件: " << filePath << std::endl;
+        return nullptr;
+    }
+    // 区块按偏移表随机访问,关闭顺序预读
+    madvise(view, static_cast<size_t>(st.st_size), MADV_RANDOM);
+    region->m_data = static_cast<const char*>(view);
+    region->m_size = static_cast<size_t>(st.st_size);
+#endif
+
+    return region;
+}
+
+RegionFile::~RegionFile() {
+#ifdef _WIN32
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mappingHandle) CloseHandle(m_mappingHandle);
+    if (m_fileHandle) CloseHandle(m_fileHandle);
+#else
+    if (m_data) munmap(const_cast<char*>(m_data), m_size);
+    if (m_fd >= 0) ::close(m_fd);
+#endif
+}
+
+std::span<const char> RegionFile::GetChunkPayload(int localX, int localZ, uint8_t& compressionType) const {
+    compressionType = 0;
+    if (localX < 0 || localX >= 32 || localZ < 0 || localZ >= 32) {
+        return {};
+    }
+
+    // 偏移表:每项4字节,前3字节为扇区偏移(大端),第4字节为扇区数
+    size_t index = static_cast<size_t>(localX + localZ * 32) * 4;
+    if (m_size < index + 4) {
+        return {};
+    }
+    const uint8_t* header = reinterpret_cast<const uint8_t*>(m_data) + index;
+    uint32_t sectorOffset = (uint32_t(header[0]) << 16) | (uint32_t(header[1]) << 8) | uint32_t(header[2]);
+    if (sectorOffset == 0) {
+        return {};
+    }
+
+    // 区块头:4字节长度(大端,包含压缩类型字节) + 1字节压缩类型
+    uint64_t offset = static_cast<uint64_t>(sectorOffset) * kSectorSize;
+    if (offset + 5 > m_size) {
+        std::cerr << "错误: 区块偏移超出了文件边界: " << m_path << std::endl;
+        return {};
+    }
+    const uint8_t* chunkHeader = reinterpret_cast<const uint8_t*>(m_data) + offset;
+    uint32_t length = (uint32_t(chunkHeader[0]) << 24) | (uint32_t(chunkHeader[1]) << 16) |
+        (uint32_t(chunkHeader[2]) << 8) | uint32_t(chunkHeader[3]);
+    if (length == 0 || offset + 4 + length > m_size) {
+        std::cerr << "错误: 区块数据超出了文件边界: " << m_path << std::endl;
+        return {};
+    }
+
+    compressionType = chunkHeader[4];
+    return { m_data + offset + 5, static_cast<size_t>(length - 1) };
+}
+
+size_t RegionFile::Prefetch(std::span<const char> range) const {
+    if (range.empty() || range.data() < m_data || range.data() + range.size() > m_data + m_size) {
+        return 0;
+    }
+
+    // 按页对齐到映射内部
+    static const size_t pageSize = [] {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return static_cast<size_t>(info.dwPageSize);
+#else
+        long size = sysconf(_SC_PAGESIZE);
+        return size > 0 ? static_cast<size_t>(size) : size_t(4096);
+#endif
+    }();
+    size_t begin = static_cast<size_t>(range.data() - m_data) / pageSize * pageSize;
+    size_t end = (std::min)(m_size, static_cast<size_t>(range.data() - m_data) + range.size());
+    size_t length = end - begin;
+
+#ifndef _WIN32
+    madvise(const_cast<char*>(m_data + begin), length, MADV_WILLNEED);
+#endif
+
+    // 逐页读取一个字节,确保数据真正从磁盘读入(WILLNEED 只是提示)
+    volatile char sink = 0;
+    for (size_t offset = begin; offset < end; offset += pageSize) {
+        sink = sink + m_data[offset];
+    }
+    (void)sink;
+    return length;
+}
@@ -0,0 +1,55 @@
+// RegionFile.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+
+// 以只读内存映射方式打开的 .mca 区域文件
+// 文件内容不会被复制到堆上,区块负载直接以 span 的形式指向页缓存
+class RegionFile {
+public:
+    // 区域文件扇区大小(4KB)
+    static constexpr size_t kSectorSize = 4096;
+    // 文件头大小:1024 个偏移项 + 1024 个时间戳
+    static constexpr size_t kHeaderSize = kSectorSize * 2;
+
+    // 打开并映射区域文件,失败(不存在、为空、映射失败)时返回 nullptr
+    static std::shared_ptr<RegionFile> Open(const std::string& filePath);
+
+    ~RegionFile();
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    // 整个文件的只读视图
+    std::span<const char> Data() const { return { m_data, m_size }; }
+
+    // 映射的字节数
+    size_t Size() const { return m_size; }
+
+    const std::string& Path() const { return m_path; }
+
+    // 获取区块(区域内相对坐标 0-31)的压缩负载
+    // compressionType 输出压缩类型字节;区块不存在或越界时返回空 span
+    std::span<const char> GetChunkPayload(int localX, int localZ, uint8_t& compressionType) const;
+
+    // 提示内核预读映射中的一段字节并逐页访问,使其进入页缓存
+    // 返回实际预读的字节数(按页对齐后)
+    size_t Prefetch(std::span<const char> range) const;
+
+private:
+    RegionFile() = default;
+
+    std::string m_path;
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_fileHandle = nullptr;
+    void* m_mappingHandle = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
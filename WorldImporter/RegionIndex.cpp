@@ -0,0 +1,175 @@
+// RegionIndex.cpp
+#include "RegionIndex.h"
+#include "config.h"
+#include "hashutils.h"
+#include "locutil.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace RegionIndex {
+
+    namespace {
+        constexpr size_t kChunksPerRegion = 1024;
+        constexpr size_t kHeaderBytes = 8192;
+
+        std::once_flag buildOnce;
+        std::string regionDirectory;
+
+        // 区域坐标 -> 在 locations/timestamps 中的槽位
+        std::unordered_map<std::pair<int, int>, uint32_t, pair_hash> regionSlots;
+        // 每个区域 1024 项,原始大端解析后的值:高24位为扇区偏移,低8位为扇区数
+        std::vector<uint32_t> locations;
+        std::vector<uint32_t> timestamps;
+
+        // 根据配置的选择维度和存档路径，返回对应的 region 目录路径
+        std::string ResolveRegionDirectory() {
+            const std::string& sel = config.selectedDimension;
+            const std::string& base = config.worldPath;
+            std::string dir;
+            if (sel == "minecraft:overworld") {
+                dir = base + "/region";
+            } else if (sel == "minecraft:the_nether") {
+                dir = base + "/DIM-1/region";
+            } else if (sel == "minecraft:the_end") {
+                dir = base + "/DIM1/region";
+            } else {
+                auto pos = sel.find(':');
+                if (pos == std::string::npos) {
+                    dir = base + "/region";
+                } else {
+                    std::string ns = sel.substr(0, pos);
+                    std::string dimName = sel.substr(pos + 1);
+                    dir = base + "/dimensions/" + ns + "/" + dimName + "/region";
+                }
+            }
+            if (!std::filesystem::exists(dir)) {
+                std::cerr << "警告: 维度目录不存在: " << dir << std::endl;
+                // 回退到主世界 region
+                return base + "/region";
+            }
+            return dir;
+        }
+
+        // 解析 r.X.Z.mca 文件名
+        bool ParseRegionFileName(const std::string& name, int& regionX, int& regionZ) {
+            if (name.size() < 9 || name.compare(0, 2, "r.") != 0 || name.compare(name.size() - 4, 4, ".mca") != 0) {
+                return false;
+            }
+            std::string coords = name.substr(2, name.size() - 6);
+            size_t dot = coords.find('.');
+            if (dot == std::string::npos) {
+                return false;
+            }
+            try {
+                size_t used = 0;
+                regionX = std::stoi(coords.substr(0, dot), &used);
+                if (used != dot) return false;
+                std::string zPart = coords.substr(dot + 1);
+                regionZ = std::stoi(zPart, &used);
+                return used == zPart.size();
+            }
+            catch (...) {
+                return false;
+            }
+        }
+
+        inline uint32_t ReadBigEndian32(const unsigned char* p) {
+            return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | uint32_t(p[3]);
+        }
+
+        void BuildIndex() {
+            regionDirectory = ResolveRegionDirectory();
+
+            std::error_code ec;
+            std::filesystem::directory_iterator dirIt(regionDirectory, ec);
+            if (ec) {
+                std::cerr << "错误: 无法读取 region 目录: " << regionDirectory << std::endl;
+                return;
+            }
+
+            unsigned char header[kHeaderBytes];
+            for (const auto& entry : dirIt) {
+                if (!entry.is_regular_file(ec)) continue;
+                int regionX, regionZ;
+                if (!ParseRegionFileName(entry.path().filename().string(), regionX, regionZ)) continue;
+
+                // 只读取文件头,不足 8KB 的文件视为没有任何区块
+                std::ifstream file(entry.path(), std::ios::binary);
+                if (!file) continue;
+                file.read(reinterpret_cast<char*>(header), kHeaderBytes);
+                if (file.gcount() != static_cast<std::streamsize>(kHeaderBytes)) continue;
+
+                uint32_t slot = static_cast<uint32_t>(regionSlots.size());
+                regionSlots.emplace(std::make_pair(regionX, regionZ), slot);
+                locations.resize(locations.size() + kChunksPerRegion);
+                timestamps.resize(timestamps.size() + kChunksPerRegion);
+                uint32_t* loc = locations.data() + slot * kChunksPerRegion;
+                uint32_t* ts = timestamps.data() + slot * kChunksPerRegion;
+                for (size_t i = 0; i < kChunksPerRegion; ++i) {
+                    loc[i] = ReadBigEndian32(header + i * 4);
+                    ts[i] = ReadBigEndian32(header + 4096 + i * 4);
+                }
+            }
+        }
+
+        inline void EnsureBuilt() {
+            std::call_once(buildOnce, BuildIndex);
+        }
+
+        // 返回区块在紧凑数组中的下标,区域不存在时返回 -1
+        inline long long ChunkSlot(int chunkX, int chunkZ) {
+            EnsureBuilt();
+            int regionX, regionZ;
+            chunkToRegion(chunkX, chunkZ, regionX, regionZ);
+            auto it = regionSlots.find({ regionX, regionZ });
+            if (it == regionSlots.end()) return -1;
+            return static_cast<long long>(it->second) * kChunksPerRegion + mod32(chunkX) + mod32(chunkZ) * 32;
+        }
+    }
+
+    void Build() {
+        EnsureBuilt();
+    }
+
+    const std::string& GetRegionDirectory() {
+        EnsureBuilt();
+        return regionDirectory;
+    }
+
+    std::string GetRegionFilePath(int regionX, int regionZ) {
+        std::ostringstream filePathStream;
+        filePathStream << GetRegionDirectory() << "/r." << regionX << "." << regionZ << ".mca";
+        return filePathStream.str();
+    }
+
+    bool HasRegion(int regionX, int regionZ) {
+        EnsureBuilt();
+        return regionSlots.count({ regionX, regionZ }) != 0;
+    }
+
+    bool HasChunk(int chunkX, int chunkZ) {
+        long long slot = ChunkSlot(chunkX, chunkZ);
+        return slot >= 0 && (locations[slot] >> 8) != 0;
+    }
+
+    uint32_t GetChunkSectorCount(int chunkX, int chunkZ) {
+        long long slot = ChunkSlot(chunkX, chunkZ);
+        if (slot < 0 || (locations[slot] >> 8) == 0) return 0;
+        return locations[slot] & 0xFF;
+    }
+
+    uint32_t GetChunkTimestamp(int chunkX, int chunkZ) {
+        long long slot = ChunkSlot(chunkX, chunkZ);
+        return slot < 0 ? 0 : timestamps[slot];
+    }
+
+    size_t GetRegionCount() {
+        EnsureBuilt();
+        return regionSlots.size();
+    }
+}
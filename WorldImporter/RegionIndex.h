@@ -0,0 +1,36 @@
+// RegionIndex.h
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// 区域头索引:对当前维度的 region 目录只扫描一次,
+// 读取每个 .mca 文件开头的 8KB(偏移/扇区数表与时间戳表)并保存在紧凑数组中。
+// 之后的区块存在性、大小查询都是 O(1) 且不再访问文件系统。
+namespace RegionIndex {
+
+    // 扫描 region 目录并建立索引(线程安全,只会执行一次;查询函数会在首次调用时自动触发)
+    void Build();
+
+    // 当前维度对应的 region 目录(已处理维度回退)
+    const std::string& GetRegionDirectory();
+
+    // 区域文件路径 r.X.Z.mca
+    std::string GetRegionFilePath(int regionX, int regionZ);
+
+    // 区域文件是否存在
+    bool HasRegion(int regionX, int regionZ);
+
+    // 区块是否存在于区域文件中(全局区块坐标)
+    bool HasChunk(int chunkX, int chunkZ);
+
+    // 区块占用的 4KB 扇区数,不存在时返回 0
+    uint32_t GetChunkSectorCount(int chunkX, int chunkZ);
+
+    // 区块最后保存时间戳(秒),不存在时返回 0
+    uint32_t GetChunkTimestamp(int chunkX, int chunkZ);
+
+    // 已索引的区域数量
+    size_t GetRegionCount();
+}
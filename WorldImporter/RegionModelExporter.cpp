@@ -20,6 +20,11 @@
 #include <shared_mutex>
 #include "block.h"
 #include "TaskMonitor.h"
+#include "RegionCache.h"
+#include "RegionIndex.h"
+#include "RegionPrefetcher.h"
+#include "EpochManager.h"
+#include "EntityMesher.h"
 using namespace std;
 using namespace std::chrono;  // 新增:方便使用 chrono
 
@@ -56,6 +61,10 @@ void RegionModelExporter::ExportModels(const string& outputName) {
     int totalChunks = totalChunksX * totalChunksZ;
     monitor.UpdateProgress("区块LOD计算", 0, totalChunks);
 
+    // 扫描当前维度的区域文件头,后续区块存在性查询不再访问文件系统
+    RegionIndex::Build();
+    std::cout << "区域索引: " << RegionIndex::GetRegionCount() << " 个区域文件" << std::endl;
+
     // 预先计算所有区块的LOD等级
     ChunkLoader::CalculateChunkLODs(expandedChunkXStart, expandedChunkXEnd, expandedChunkZStart, expandedChunkZEnd,
         sectionYStart, sectionYEnd);
@@ -89,11 +98,11 @@ void RegionModelExporter::ExportModels(const string& outputName) {
 
     // 用于跟踪已处理的区块，避免重复生成生物群系数据
     std::unordered_set<std::pair<int, int>, pair_hash> processedBiomeChunks;
-    std::mutex biomeMutex;
 
     // 模型处理阶段
     ModelData finalMergedModel;
-    std::unordered_map<string, string> uniqueMaterials;
+    MeshBuilder finalBuilder; // 完整导出时各组网格追加到这里,材质已是全局ID
+    std::unordered_set<uint32_t> uniqueMaterials;
 
     // 计算所有批次的总任务数
     size_t totalTasksAllBatches = 0;
@@ -114,24 +123,31 @@ void RegionModelExporter::ExportModels(const string& outputName) {
     // 初始化全局进度
     monitor.UpdateProgress("总体进度", 0, totalTasksAllBatches);
     
-    auto processModel = [](const ChunkTask& task) -> ModelData {
+    // 任务实际使用的 LOD 大小,0 表示完整模型
+    auto effectiveLodSize = [](const ChunkTask& task) -> float {
         // 如果 activeLOD 为 false,则始终生成完整模型
         if (!config.activeLOD) {
-            return ChunkGenerator::GenerateChunkModel(task.chunkX, task.sectionY, task.chunkZ);
+            return 0.0f;
         }
-
-        // 如果 LOD0renderDistance 为 0 且是普通区块,跳过生成
+        // LOD0 禁用时,将中央区块按 LOD1 生成
         if (config.LOD0renderDistance == 0 && task.lodLevel == 0.0f) {
-            // LOD0 禁用时,将中央区块按 LOD1 生成
-            return ChunkGenerator::GenerateLODChunkModel(task.chunkX, task.sectionY, task.chunkZ, 1.0f);
+            return 1.0f;
         }
-        if (task.lodLevel == 0.0f) {
-            return ChunkGenerator::GenerateChunkModel(task.chunkX, task.sectionY, task.chunkZ);
+        return task.lodLevel;
+    };
+
+    auto processModel = [&](const ChunkTask& task, MeshBuilder& builder) {
+        const float lodSize = effectiveLodSize(task);
+        if (lodSize == 0.0f) {
+            ChunkGenerator::GenerateChunkModel(builder, task.chunkX, task.sectionY, task.chunkZ);
         } else {
-            return ChunkGenerator::GenerateLODChunkModel(task.chunkX, task.sectionY, task.chunkZ, task.lodLevel);
+            ChunkGenerator::GenerateLODChunkModel(builder, task.chunkX, task.sectionY, task.chunkZ, lodSize);
         }
     };
 
+    // 每个批次的实体方块子模型
+    EntityMesher entityMesher;
+
     std::mutex finalModelMutex;
     std::mutex materialsMutex;
     std::mutex progressMutex;
@@ -139,16 +155,11 @@ void RegionModelExporter::ExportModels(const string& outputName) {
     // 线程安全的合并操作
     auto mergeToFinalModel = [&](ModelData&& model) {
         std::lock_guard<std::mutex> lock(finalModelMutex);
-        if (finalMergedModel.vertices.empty()) {
-            finalMergedModel = std::move(model);
-        }
-        else {
-            MergeModelsDirectly(finalMergedModel, model);
-        }
+        finalBuilder.AppendMesh(model);
         };
 
     // 线程安全的材质记录
-    auto recordMaterials = [&](const std::unordered_map<string, string>& newMaterials) {
+    auto recordMaterials = [&](const std::unordered_set<uint32_t>& newMaterials) {
         std::lock_guard<std::mutex> lock(materialsMutex);
         uniqueMaterials.insert(newMaterials.begin(), newMaterials.end());
         };
@@ -160,8 +171,11 @@ void RegionModelExporter::ExportModels(const string& outputName) {
         return std::make_tuple(b.chunkXStart - 1, b.chunkXEnd + 1, b.chunkZStart - 1, b.chunkZEnd + 1);
     };
 
+    // 上一批次的后台卸载
+    std::future<void> pendingUnload;
+
     for (size_t current_batch_idx = 0; current_batch_idx < ChunkGroupAllocator::g_chunkBatches.size(); ++current_batch_idx) {
-        const auto& batch = ChunkGroupAllocator::g_chunkBatches[current_batch_idx];
+        auto& batch = ChunkGroupAllocator::g_chunkBatches[current_batch_idx];
         batchId = current_batch_idx + 1;
         
         // 更新批次进度
@@ -173,16 +187,86 @@ void RegionModelExporter::ExportModels(const string& outputName) {
         int bExpXStart, bExpXEnd, bExpZStart, bExpZEnd;
         std::tie(bExpXStart, bExpXEnd, bExpZStart, bExpZEnd) = get_batch_expanded_coords(batch);
 
+        // 当前批次与下一批次涉及的区域常驻缓存,其余区域允许被 LRU 淘汰
+        std::unordered_set<std::pair<int, int>, pair_hash> retainRegions;
+        for (size_t idx = current_batch_idx; idx < std::min(current_batch_idx + 2, ChunkGroupAllocator::g_chunkBatches.size()); ++idx) {
+            int rxStart, rxEnd, rzStart, rzEnd;
+            std::tie(rxStart, rxEnd, rzStart, rzEnd) = get_batch_expanded_coords(ChunkGroupAllocator::g_chunkBatches[idx]);
+            for (int rx = rxStart >> 5; rx <= (rxEnd >> 5); ++rx) {
+                for (int rz = rzStart >> 5; rz <= (rzEnd >> 5); ++rz) {
+                    retainRegions.insert({ rx, rz });
+                }
+            }
+        }
+        SetRegionCacheRetainSet(retainRegions);
+
+        // 子区块稠密窗口移到当前批次(含边界),上一批次保留的区块会重新登记
+        sectionGrid.SetWindow(bExpXStart, bExpXEnd, bExpZStart, bExpZEnd);
+
         size_t beforeLoad = CountLoadedChunks();
         ChunkLoader::LoadChunks(bExpXStart, bExpXEnd, bExpZStart, bExpZEnd,
                                 sectionYStart, sectionYEnd);
         size_t afterLoad = CountLoadedChunks();
         size_t newlyLoaded = (afterLoad > beforeLoad) ? (afterLoad - beforeLoad) : 0;
 
+        // 当前批次生成模型期间,在后台把下一批次的区块数据读入页缓存
+        if (current_batch_idx + 1 < ChunkGroupAllocator::g_chunkBatches.size()) {
+            int nXStart, nXEnd, nZStart, nZEnd;
+            std::tie(nXStart, nXEnd, nZStart, nZEnd) = get_batch_expanded_coords(ChunkGroupAllocator::g_chunkBatches[current_batch_idx + 1]);
+            RegionPrefetcher::GetInstance().PrefetchChunks(nXStart, nXEnd, nZStart, nZEnd);
+        }
+
+        // 上一批次的后台卸载与本批次的加载重叠,到这里必须完成:
+        // 之后遍历并修改已加载的子区块,不能与摘除、释放区块同时进行
+        if (pendingUnload.valid()) {
+            pendingUnload.get();
+        }
+
         // 处理天空光照邻居标志(在模型线程前执行,避免写冲突)
         UpdateSkyLightNeighborFlags();
 
+        // 为本批次的每个区块生成生物群系地图数据(如果尚未生成)
+        // 在剪除任务之前按区块进行,全空或被完全包围的区块同样需要生物群系数据
+        {
+            EpochGuard epochGuard;
+            for (const auto& group : batch.groups) {
+                for (const auto& task : group.tasks) {
+                    if (!processedBiomeChunks.insert({ task.chunkX, task.chunkZ }).second) continue;
+                    // 计算当前区块的方块坐标范围
+                    int blockXStart = task.chunkX * 16;
+                    int blockXEnd = blockXStart + 15;
+                    int blockZStart = task.chunkZ * 16;
+                    int blockZEnd = blockZStart + 15;
+                    Biome::GenerateBiomeMap(blockXStart, blockZStart, blockXEnd, blockZEnd);
+                }
+            }
+        }
+
+        // 根据子区块摘要移除全空气、被完全包围的子区块任务,移除的任务直接计入完成数
+        // 实体方块按区块输出且不限高度(可能在导出的子区块范围之外),含实体方块的区块至少保留一个完整模型任务
+        {
+            EpochGuard epochGuard;
+            std::unordered_set<std::pair<int, int>, pair_hash> entityChunksKept;
+            size_t pruned = ChunkGroupAllocator::PruneEmptyTasks(batch, [&](const ChunkTask& task) {
+                const float lodSize = effectiveLodSize(task);
+                if (ChunkGenerator::MayEmitGeometry(task.chunkX, task.sectionY, task.chunkZ, lodSize)) {
+                    return true;
+                }
+                if (lodSize != 0.0f) return false;
+                const ChunkColumn* column = sectionGrid.FindColumn(task.chunkX, task.chunkZ);
+                return column && column->hasEntityBlocks &&
+                    entityChunksKept.insert({ task.chunkX, task.chunkZ }).second;
+            });
+            globalCompletedTasks.fetch_add(pruned);
+        }
+
         // ---------- 处理当前批次 ----------
+        monitor.SetStatus(TaskStatus::GENERATING_MODELS, "生成批次 " + to_string(batchId) + " 实体方块");
+        // 实体方块先去重并并行生成子模型,各组只追加实例
+        entityMesher.Prepare(batch.groups, [&](const ChunkTask& task) {
+            return effectiveLodSize(task) == 0.0f;
+        });
+
         monitor.SetStatus(TaskStatus::GENERATING_MODELS, "生成批次 " + to_string(batchId) + " 模型");
         const auto& groupsInBatch = batch.groups;
         
@@ -206,11 +290,12 @@ void RegionModelExporter::ExportModels(const string& outputName) {
                     size_t idx = groupIndex.fetch_add(1);
                     if (idx >= groupsInBatch.size()) break;
                     const auto& group = groupsInBatch[idx];
-                    ModelData groupModel;
-                    groupModel.vertices.reserve(4096 * group.tasks.size());
-                    groupModel.faces.reserve(8192 * group.tasks.size());
-                    groupModel.uvCoordinates.reserve(4096 * group.tasks.size());
-                    std::unordered_map<string, string> localMaterials;
+                    // 组内读取的子区块在作用域结束前不会被上一批次的卸载释放
+                    EpochGuard epochGuard;
+                    // 组内所有区块直接追加到本线程的构建器,缓冲区在组之间复用
+                    MeshBuilder& builder = MeshBuilder::ForThread();
+                    builder.Reset();
+                    std::unordered_set<uint32_t> localMaterials;
 
                     // 记录当前组内需要处理的任务数
                     size_t tasksInCurrentGroup = group.tasks.size();
@@ -218,32 +303,7 @@ void RegionModelExporter::ExportModels(const string& outputName) {
 
                     // 合并组内所有区块模型
                     for (const auto& task : group.tasks) {
-                        // 为当前区块生成生物群系地图数据 (如果尚未生成)
-                        std::pair<int, int> chunkKey = {task.chunkX, task.chunkZ};
-                        {
-                            std::lock_guard<std::mutex> lock(biomeMutex);
-                            if (processedBiomeChunks.find(chunkKey) == processedBiomeChunks.end()) {
-                                // 计算当前区块的方块坐标范围
-                                int blockXStart = task.chunkX * 16;
-                                int blockXEnd = blockXStart + 15;
-                                int blockZStart = task.chunkZ * 16;
-                                int blockZEnd = blockZStart + 15;
-                                // 生成该区块的生物群系地图数据
-                                Biome::GenerateBiomeMap(blockXStart, blockZStart, blockXEnd, blockZEnd);
-                                processedBiomeChunks.insert(chunkKey);
-                            }
-                        }
-
-                        ModelData chunkModel;
-                            chunkModel.vertices.reserve(4096);
-                            chunkModel.faces.reserve(8192);
-                            chunkModel.uvCoordinates.reserve(4096);
-                            chunkModel = processModel(task);
-                        if (groupModel.vertices.empty()) {
-                            groupModel = std::move(chunkModel);
-                        } else {
-                            MergeModelsDirectly(groupModel, chunkModel);
-                        }
+                        processModel(task, builder);
                         
                         // 更新批次完成任务计数
                         batchCompletedTasks.fetch_add(1);
@@ -271,7 +331,9 @@ void RegionModelExporter::ExportModels(const string& outputName) {
                             }
                         }
                     }
-                    if (groupModel.vertices.empty()) continue;
+                    entityMesher.AppendGroup(idx, builder);
+                    if (builder.Empty()) continue;
+                    ModelData groupModel = builder.Take();
                     if (config.exportFullModel) {
                         mergeToFinalModel(std::move(groupModel));
                     } else {
@@ -304,10 +366,10 @@ void RegionModelExporter::ExportModels(const string& outputName) {
         for (auto& t : threads) {
             if (t.joinable()) t.join();
         }
+        entityMesher.Clear();
 
         // ---------- 卸载当前批次 ----------
-        size_t beforeUnload = CountLoadedChunks();
-
+        // 上一批次的卸载已在本批次加载后完成,两次卸载不重叠
         // 构建需要为未来批次保留的扩展区块集合
         std::unordered_set<std::pair<int, int>, pair_hash> retain_for_future_batches;
         for (size_t future_batch_idx = current_batch_idx + 1; future_batch_idx < ChunkGroupAllocator::g_chunkBatches.size(); ++future_batch_idx) {
@@ -321,12 +383,28 @@ void RegionModelExporter::ExportModels(const string& outputName) {
             }
         }
 
-        ChunkLoader::UnloadChunks(bExpXStart, bExpXEnd, bExpZStart, bExpZEnd, sectionYStart, sectionYEnd, retain_for_future_batches);
-        size_t afterUnload = CountLoadedChunks();
-        size_t unloadedCnt = (beforeUnload > afterUnload) ? (beforeUnload - afterUnload) : 0;
+        // 卸载在后台进行,与下一批次的加载重叠(下一批次加载完成后等待其结束);
+        // 被摘除的区块由 EpochManager 在没有读线程引用后释放
+        pendingUnload = std::async(std::launch::async,
+            [=, retain = std::move(retain_for_future_batches)]() {
+                ChunkLoader::UnloadChunks(bExpXStart, bExpXEnd, bExpZStart, bExpZEnd, sectionYStart, sectionYEnd, retain);
+                EpochManager::GetInstance().Reclaim();
+            });
+
+        std::cout << "批次" << batchId << "完成：新加载区块 " << newlyLoaded << ", 已加载 " << afterLoad << std::endl;
+
+        RegionCacheStats regionStats = GetRegionCacheStats();
+        std::cout << "区域缓存: 命中 " << regionStats.hits << ", 未命中 " << regionStats.misses
+                  << ", 淘汰 " << regionStats.evictions << ", 常驻 " << (regionStats.residentBytes >> 20) << "MB" << std::endl;
+    }
 
-        std::cout << "批次" << batchId << "完成：新加载区块 " << newlyLoaded << "," << unloadedCnt << "," << afterUnload<<std::endl;
+    if (pendingUnload.valid()) {
+        pendingUnload.get();
     }
+    EpochManager::GetInstance().Reclaim();
+    RegionPrefetcher::GetInstance().Cancel();
+    // 之后不再读取区块,释放所有区域文件的映射
+    ClearRegionCache();
 
     // 导出不同类型的生物群系颜色图片
     monitor.SetStatus(TaskStatus::EXPORTING_MODELS, "BiomeExportToPNG");
@@ -338,6 +416,7 @@ void RegionModelExporter::ExportModels(const string& outputName) {
     Biome::ExportToPNG("fog.png", BiomeColorType::Fog);
     Biome::ExportToPNG("sky.png", BiomeColorType::Sky);
     // 最终导出处理
+    finalMergedModel = finalBuilder.Release();
     if (config.exportFullModel && !finalMergedModel.vertices.empty()) {
         monitor.SetStatus(TaskStatus::DEDUPLICATING_VERTICES, "DeduplicateModel");
         ModelDeduplicator::DeduplicateModel(finalMergedModel);
@@ -0,0 +1,137 @@
+// RegionPrefetcher.cpp
+#include "RegionPrefetcher.h"
+#include "RegionCache.h"
+#include "RegionIndex.h"
+#include "locutil.h"
+#include "config.h"
+#include <algorithm>
+
+RegionPrefetcher& RegionPrefetcher::GetInstance() {
+    static RegionPrefetcher instance;
+    return instance;
+}
+
+RegionPrefetcher::RegionPrefetcher() {
+    m_worker = std::thread(&RegionPrefetcher::WorkerLoop, this);
+}
+
+RegionPrefetcher::~RegionPrefetcher() {
+    Stop();
+}
+
+void RegionPrefetcher::PrefetchChunks(int chunkXStart, int chunkXEnd, int chunkZStart, int chunkZEnd) {
+    if (config.prefetchBudgetMB == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopping) return;
+    // 新请求使旧请求作废
+    uint64_t generation = m_generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    m_queue.clear();
+    ReleaseOutstandingLocked();
+    m_queue.push_back({ chunkXStart, chunkXEnd, chunkZStart, chunkZEnd, generation });
+    m_cv.notify_one();
+}
+
+void RegionPrefetcher::Cancel() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+    m_queue.clear();
+    ReleaseOutstandingLocked();
+}
+
+void RegionPrefetcher::ReleaseOutstandingLocked() {
+    m_outstanding.clear();
+    m_inFlightBytes.store(0, std::memory_order_relaxed);
+    m_budgetCv.notify_all();
+}
+
+void RegionPrefetcher::OnChunkConsumed(int chunkX, int chunkZ) {
+    // 绝大多数时候没有在途的预读,不必加锁
+    if (m_inFlightBytes.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_outstanding.find({ chunkX, chunkZ });
+    if (it == m_outstanding.end()) {
+        return;
+    }
+    m_inFlightBytes.fetch_sub(it->second, std::memory_order_relaxed);
+    m_outstanding.erase(it);
+    m_budgetCv.notify_one();
+}
+
+void RegionPrefetcher::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping) return;
+        m_stopping = true;
+        m_generation.fetch_add(1, std::memory_order_acq_rel);
+        m_queue.clear();
+        ReleaseOutstandingLocked();
+    }
+    m_cv.notify_all();
+    if (m_worker.joinable()) {
+        m_worker.join();
+    }
+}
+
+void RegionPrefetcher::WorkerLoop() {
+    while (true) {
+        PrefetchRequest request;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this] { return m_stopping || !m_queue.empty(); });
+            if (m_stopping) return;
+            request = m_queue.front();
+            m_queue.pop_front();
+        }
+        ProcessRequest(request);
+    }
+}
+
+void RegionPrefetcher::ProcessRequest(const PrefetchRequest& request) {
+    const uint64_t budget = static_cast<uint64_t>(config.prefetchBudgetMB) * 1024 * 1024;
+    auto cancelled = [&]() {
+        return m_stopping || m_generation.load(std::memory_order_acquire) != request.generation;
+    };
+
+    // 按区域分组遍历,同一区域内按文件顺序(z 主序)读取,尽量顺序访问磁盘
+    int regionXStart = request.chunkXStart >> 5, regionXEnd = request.chunkXEnd >> 5;
+    int regionZStart = request.chunkZStart >> 5, regionZEnd = request.chunkZEnd >> 5;
+    for (int regionZ = regionZStart; regionZ <= regionZEnd; ++regionZ) {
+        for (int regionX = regionXStart; regionX <= regionXEnd; ++regionX) {
+            if (!RegionIndex::HasRegion(regionX, regionZ)) continue;
+            auto region = GetRegionFromCache(regionX, regionZ);
+            if (!region) continue;
+
+            int zStart = std::max(request.chunkZStart, regionZ * 32);
+            int zEnd = std::min(request.chunkZEnd, regionZ * 32 + 31);
+            int xStart = std::max(request.chunkXStart, regionX * 32);
+            int xEnd = std::min(request.chunkXEnd, regionX * 32 + 31);
+            for (int chunkZ = zStart; chunkZ <= zEnd; ++chunkZ) {
+                for (int chunkX = xStart; chunkX <= xEnd; ++chunkX) {
+                    if (!RegionIndex::HasChunk(chunkX, chunkZ)) continue;
+                    uint8_t compressionType = 0;
+                    auto payload = region->GetChunkPayload(mod32(chunkX), mod32(chunkZ), compressionType);
+                    if (payload.empty()) continue;
+                    const uint64_t bytes = payload.size();
+                    {
+                        // 在途字节超出预算时等待加载线程读取已预读的区块;请求作废时停止
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_budgetCv.wait(lock, [&]() {
+                            const uint64_t inFlight = m_inFlightBytes.load(std::memory_order_relaxed);
+                            return cancelled() || inFlight == 0 || inFlight + bytes <= budget;
+                        });
+                        if (cancelled()) {
+                            return;
+                        }
+                        m_outstanding[{ chunkX, chunkZ }] += bytes;
+                        m_inFlightBytes.fetch_add(bytes, std::memory_order_relaxed);
+                    }
+                    m_prefetchedBytes.fetch_add(region->Prefetch(payload), std::memory_order_relaxed);
+                }
+            }
+        }
+    }
+}
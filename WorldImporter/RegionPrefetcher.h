@@ -0,0 +1,69 @@
+// RegionPrefetcher.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include "hashutils.h"
+
+// 区域预读器:在后台线程中把下一批次需要的区块字节读入页缓存,
+// 使磁盘读取与当前批次的网格生成重叠
+// 已预读、尚未被加载线程读取的字节数不超过 config.prefetchBudgetMB,超出时后台线程等待加载线程读取
+class RegionPrefetcher {
+public:
+    // 获取单例实例
+    static RegionPrefetcher& GetInstance();
+
+    // 提交一个区块矩形(闭区间)的预读请求;会取消尚未完成的旧请求
+    void PrefetchChunks(int chunkXStart, int chunkXEnd, int chunkZStart, int chunkZEnd);
+
+    // 取消所有未完成的预读请求
+    void Cancel();
+
+    // 停止后台线程(程序退出前调用,可重复调用)
+    void Stop();
+
+    // 加载线程读取区块后调用,归还该区块占用的预读预算
+    void OnChunkConsumed(int chunkX, int chunkZ);
+
+    // 累计预读的字节数
+    uint64_t GetPrefetchedBytes() const { return m_prefetchedBytes.load(std::memory_order_relaxed); }
+
+    // 已预读但尚未被读取的字节数
+    uint64_t GetInFlightBytes() const { return m_inFlightBytes.load(std::memory_order_relaxed); }
+
+private:
+    struct PrefetchRequest {
+        int chunkXStart, chunkXEnd, chunkZStart, chunkZEnd;
+        uint64_t generation;
+    };
+
+    RegionPrefetcher();
+    ~RegionPrefetcher();
+
+    RegionPrefetcher(const RegionPrefetcher&) = delete;
+    RegionPrefetcher& operator=(const RegionPrefetcher&) = delete;
+
+    void WorkerLoop();
+    void ProcessRequest(const PrefetchRequest& request);
+    // 丢弃尚未被读取的预读记录并唤醒等待预算的后台线程(调用方持有 m_mutex)
+    void ReleaseOutstandingLocked();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_budgetCv; // 预算归还或请求作废时唤醒后台线程
+    std::deque<PrefetchRequest> m_queue;
+    std::thread m_worker;
+    bool m_stopping = false;
+    std::atomic<uint64_t> m_generation{ 0 };
+    std::atomic<uint64_t> m_prefetchedBytes{ 0 };
+    // 已预读、尚未被读取的区块及其字节数(受 m_mutex 保护),m_inFlightBytes 为其总和
+    std::unordered_map<std::pair<int, int>, uint64_t, pair_hash> m_outstanding;
+    std::atomic<uint64_t> m_inFlightBytes{ 0 };
+};
@@ -0,0 +1,144 @@
+// SectionGrid.cpp
+#include "SectionGrid.h"
+#include "EpochManager.h"
+#include <mutex>
+
+SectionGrid sectionGrid;
+
+void SectionGrid::SetWindow(int chunkXStart, int chunkXEnd, int chunkZStart, int chunkZEnd) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    Window* window = nullptr;
+    if (chunkXEnd >= chunkXStart && chunkZEnd >= chunkZStart) {
+        window = new Window();
+        window->x = chunkXStart;
+        window->z = chunkZStart;
+        window->width = static_cast<unsigned>(chunkXEnd - chunkXStart + 1);
+        window->depth = static_cast<unsigned>(chunkZEnd - chunkZStart + 1);
+        const size_t slotCount = static_cast<size_t>(window->width) * window->depth;
+        window->slots.reset(new std::atomic<ChunkColumn*>[slotCount]);
+        for (size_t i = 0; i < slotCount; ++i) {
+            window->slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+
+        // 把已加载(例如上一批次保留下来)的区块登记到新窗口
+        for (const auto& entry : m_columns) {
+            unsigned dx = static_cast<unsigned>(entry.first.first - window->x);
+            unsigned dz = static_cast<unsigned>(entry.first.second - window->z);
+            if (dx < window->width && dz < window->depth) {
+                window->slots[static_cast<size_t>(dx) * window->depth + dz].store(entry.second.get(), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const Window* old = m_window.exchange(window, std::memory_order_acq_rel);
+    if (old) {
+        EpochManager::GetInstance().Retire([old] { delete old; });
+    }
+}
+
+ChunkColumn* SectionGrid::Insert(int chunkX, int chunkZ, std::unique_ptr<ChunkColumn> column) {
+    std::unique_ptr<ChunkColumn> replaced;
+    ChunkColumn* stored = column.get();
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto& entry = m_columns[std::make_pair(chunkX, chunkZ)];
+        replaced = std::move(entry);
+        entry = std::move(column);
+
+        if (auto* slot = WindowSlot(chunkX, chunkZ)) {
+            slot->store(stored, std::memory_order_release);
+        }
+    }
+    RetireColumn(std::move(replaced));
+    return stored;
+}
+
+bool SectionGrid::BeginLoad(int chunkX, int chunkZ) {
+    if (HasColumn(chunkX, chunkZ)) {
+        return false;
+    }
+    auto key = std::make_pair(chunkX, chunkZ);
+    std::unique_lock<std::mutex> lock(m_loadMutex);
+    m_loadCv.wait(lock, [&] { return m_loading.count(key) == 0; });
+    if (HasColumn(chunkX, chunkZ)) {
+        return false;
+    }
+    m_loading.insert(key);
+    return true;
+}
+
+void SectionGrid::PublishColumn(int chunkX, int chunkZ, std::unique_ptr<ChunkColumn> column) {
+    Insert(chunkX, chunkZ, std::move(column));
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_loading.erase(std::make_pair(chunkX, chunkZ));
+    }
+    m_loadCv.notify_all();
+}
+
+void SectionGrid::Erase(int chunkX, int chunkZ) {
+    std::unique_ptr<ChunkColumn> removed;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        auto it = m_columns.find(std::make_pair(chunkX, chunkZ));
+        if (it == m_columns.end()) {
+            return;
+        }
+        if (auto* slot = WindowSlot(chunkX, chunkZ)) {
+            slot->store(nullptr, std::memory_order_release);
+        }
+        removed = std::move(it->second);
+        m_columns.erase(it);
+    }
+    RetireColumn(std::move(removed));
+}
+
+void SectionGrid::Clear() {
+    std::unordered_map<std::pair<int, int>, std::unique_ptr<ChunkColumn>, pair_hash> removed;
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        if (const Window* window = m_window.load(std::memory_order_relaxed)) {
+            const size_t slotCount = static_cast<size_t>(window->width) * window->depth;
+            for (size_t i = 0; i < slotCount; ++i) {
+                window->slots[i].store(nullptr, std::memory_order_release);
+            }
+        }
+        removed.swap(m_columns);
+    }
+    for (auto& entry : removed) {
+        RetireColumn(std::move(entry.second));
+    }
+}
+
+size_t SectionGrid::ColumnCount() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_columns.size();
+}
+
+const ChunkColumn* SectionGrid::FindOutsideWindow(int chunkX, int chunkZ) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = m_columns.find(std::make_pair(chunkX, chunkZ));
+    return it != m_columns.end() ? it->second.get() : nullptr;
+}
+
+std::atomic<ChunkColumn*>* SectionGrid::WindowSlot(int chunkX, int chunkZ) const {
+    const Window* window = m_window.load(std::memory_order_relaxed);
+    if (!window) {
+        return nullptr;
+    }
+    unsigned dx = static_cast<unsigned>(chunkX - window->x);
+    unsigned dz = static_cast<unsigned>(chunkZ - window->z);
+    if (dx >= window->width || dz >= window->depth) {
+        return nullptr;
+    }
+    return &window->slots[static_cast<size_t>(dx) * window->depth + dz];
+}
+
+void SectionGrid::RetireColumn(std::unique_ptr<ChunkColumn> column) {
+    if (!column) {
+        return;
+    }
+    ChunkColumn* raw = column.release();
+    EpochManager::GetInstance().Retire([raw] { delete raw; });
+}
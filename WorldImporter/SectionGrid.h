@@ -0,0 +1,188 @@
+// SectionGrid.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "hashutils.h"
+
+// 子区块光照:与存档相同的半字节打包(偶数索引在低4位)
+// nibbles 为空时整个子区块取 uniform;uniform 为 -1 表示存档缺少该光照,-2 表示缺少但相邻子区块有光照
+struct SectionLight {
+    std::vector<uint8_t> nibbles; // 2048 字节,均匀或缺失时为空
+    int8_t uniform = 0;
+    bool present = false;         // 存档中有该光照数据(无论是否均匀)
+
+    int Get(int yzx) const {
+        if (nibbles.empty()) {
+            return uniform;
+        }
+        uint8_t packed = nibbles[yzx >> 1];
+        return (yzx & 1) ? (packed >> 4) : (packed & 0xF);
+    }
+};
+
+// 子区块摘要:加载时统计一次,网格生成与任务分配据此跳过不会输出几何体的子区块
+struct SectionSummary {
+    uint16_t nonAirCount = 0;        // 非空气方块数(0..4096)
+    uint16_t solidCount = 0;         // solids 方块数,等于 4096 时子区块内部没有可见面
+    uint8_t solidShell = 0;          // 第 d 位表示方向 d 的外层 16x16 全为 solids(方向顺序同 SectionFaceMasks:上下西东北南)
+    bool hasFluid = false;           // 含流体或含水方块
+    bool hasEntityBlocks = false;    // 含实体方块(方块实体)
+    // 是否有模型含 DO_NOT_CULL 面的方块不在这里统计:加载期间其他线程可能尚未生成新方块状态的模型,
+    // 由网格生成阶段在需要时查询烘焙模型
+};
+
+// 紧凑的子区块缓存条目
+// 方块与群系保存为 16 位全局ID,整个子区块相同(全空气、单一调色板)时不分配数组,只保存一个值
+struct SectionCacheEntry {
+    std::vector<uint16_t> blockData; // 4096 个全局方块ID(YZX 顺序),均匀时为空
+    std::vector<uint16_t> biomeData; // 64 个群系ID(16y + 4z + x),均匀时为空
+    SectionLight skyLight;           // 天空光照
+    SectionLight blockLight;         // 方块光照
+    uint16_t uniformBlock = 0;
+    uint16_t uniformBiome = 0;
+    SectionSummary summary;          // 缺失的子区块按全空气处理,默认值即为全空气的摘要
+
+    // 整个子区块为同一方块
+    bool IsUniform() const { return blockData.empty(); }
+
+    int GetBlock(int yzx) const {
+        return blockData.empty() ? uniformBlock : blockData[yzx];
+    }
+
+    int GetBiome(int index) const {
+        return biomeData.empty() ? uniformBiome : biomeData[index];
+    }
+};
+
+// 一个区块的全部子区块,按 sectionY - minSectionY 连续存放
+// 加载失败或没有子区块的区块也会保存一个空的 ChunkColumn,表示"已加载"
+struct ChunkColumn {
+    int minSectionY = 0;
+    std::vector<SectionCacheEntry> sections;
+    bool hasEntityBlocks = false; // 区块含实体方块(任意高度,包括没有对应子区块的位置)
+    // 高度图,下标与 mapTypes 一致;每个为 256 个高度(x + z * 16),缺失时为空
+    std::array<std::vector<int>, 4> heightMaps;
+
+    const SectionCacheEntry* GetSection(int sectionY) const {
+        size_t index = static_cast<size_t>(static_cast<unsigned>(sectionY - minSectionY));
+        return index < sections.size() ? &sections[index] : nullptr;
+    }
+
+    SectionCacheEntry* GetSection(int sectionY) {
+        size_t index = static_cast<size_t>(static_cast<unsigned>(sectionY - minSectionY));
+        return index < sections.size() ? &sections[index] : nullptr;
+    }
+};
+
+// 子区块存储:按区块坐标保存 ChunkColumn
+// 导出区域(当前批次含一圈边界)使用稠密二维窗口,查询只需两次减法和数组下标;
+// 窗口外的区块通过散列表查找。窗口随批次推进用 SetWindow 滑动。
+class SectionGrid {
+public:
+    // 设置稠密窗口(区块坐标,闭区间),已加载的区块会重新登记到新窗口
+    // 新窗口原子替换旧窗口,旧窗口交给 EpochManager 延迟释放,查询线程可以同时运行
+    void SetWindow(int chunkXStart, int chunkXEnd, int chunkZStart, int chunkZEnd);
+
+    // 查找区块,未加载时返回 nullptr
+    // 返回的指针只在调用方的 EpochGuard 作用域内有效
+    const ChunkColumn* FindColumn(int chunkX, int chunkZ) const {
+        const Window* window = m_window.load(std::memory_order_acquire);
+        if (window) {
+            unsigned dx = static_cast<unsigned>(chunkX - window->x);
+            unsigned dz = static_cast<unsigned>(chunkZ - window->z);
+            if (dx < window->width && dz < window->depth) {
+                return window->slots[static_cast<size_t>(dx) * window->depth + dz].load(std::memory_order_acquire);
+            }
+        }
+        return FindOutsideWindow(chunkX, chunkZ);
+    }
+
+    ChunkColumn* FindColumn(int chunkX, int chunkZ) {
+        return const_cast<ChunkColumn*>(static_cast<const SectionGrid*>(this)->FindColumn(chunkX, chunkZ));
+    }
+
+    // 查找子区块(sectionY 为存档中的 Y,即 blockY >> 4),区块未加载或没有该子区块时返回 nullptr
+    const SectionCacheEntry* FindSection(int chunkX, int sectionY, int chunkZ) const {
+        const ChunkColumn* column = FindColumn(chunkX, chunkZ);
+        return column ? column->GetSection(sectionY) : nullptr;
+    }
+
+    SectionCacheEntry* FindSection(int chunkX, int sectionY, int chunkZ) {
+        ChunkColumn* column = FindColumn(chunkX, chunkZ);
+        return column ? column->GetSection(sectionY) : nullptr;
+    }
+
+    bool HasColumn(int chunkX, int chunkZ) const {
+        return FindColumn(chunkX, chunkZ) != nullptr;
+    }
+
+    // 保存区块(已存在时替换),返回存放后的指针
+    ChunkColumn* Insert(int chunkX, int chunkZ, std::unique_ptr<ChunkColumn> column);
+
+    // 加载去重:返回 true 表示由调用方加载该区块,之后必须调用 PublishColumn
+    // 其他线程正在加载同一区块时等待其发布;区块已加载时返回 false
+    bool BeginLoad(int chunkX, int chunkZ);
+
+    // 发布调用方在私有对象中解析好的区块,并唤醒等待该区块的线程
+    void PublishColumn(int chunkX, int chunkZ, std::unique_ptr<ChunkColumn> column);
+
+    // 移除区块;区块对象延迟到没有读线程引用时释放
+    void Erase(int chunkX, int chunkZ);
+
+    // 清空全部区块
+    void Clear();
+
+    // 已加载的区块数
+    size_t ColumnCount() const;
+
+    // 在共享锁下遍历所有区块,回调中不能再调用本类的其他方法
+    template <typename Func>
+    void ForEachColumn(Func&& func) const {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        for (const auto& entry : m_columns) {
+            func(entry.first.first, entry.first.second, *entry.second);
+        }
+    }
+
+private:
+    const ChunkColumn* FindOutsideWindow(int chunkX, int chunkZ) const;
+
+    struct Window {
+        int x = 0;
+        int z = 0;
+        unsigned width = 0;
+        unsigned depth = 0;
+        std::unique_ptr<std::atomic<ChunkColumn*>[]> slots; // 行主序:x 为行,z 为列
+    };
+
+    // 窗口槽位;不在窗口内时返回 nullptr(调用方持有 m_mutex)
+    std::atomic<ChunkColumn*>* WindowSlot(int chunkX, int chunkZ) const;
+
+    // 把区块交给 EpochManager 延迟释放
+    static void RetireColumn(std::unique_ptr<ChunkColumn> column);
+
+    mutable std::shared_mutex m_mutex;
+    std::unordered_map<std::pair<int, int>, std::unique_ptr<ChunkColumn>, pair_hash> m_columns;
+
+    // 正在加载的区块(解析在锁外进行,这里只记录状态)
+    std::mutex m_loadMutex;
+    std::condition_variable m_loadCv;
+    std::unordered_set<std::pair<int, int>, pair_hash> m_loading;
+
+    // 当前窗口;读线程无锁访问,槽位为原子指针以便加载线程并发发布区块
+    std::atomic<const Window*> m_window{ nullptr };
+};
+
+// 全局子区块存储
+extern SectionGrid sectionGrid;
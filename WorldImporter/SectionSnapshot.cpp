@@ -0,0 +1,191 @@
+// SectionSnapshot.cpp
+#include "SectionSnapshot.h"
+#include "block.h"
+#include "config.h"
+#include "locutil.h"
+
+extern Config config;
+
+void SectionSnapshot::Fill(int chunkX, int sectionY, int chunkZ) {
+    m_originX = chunkX * 16;
+    m_originY = sectionY * 16;
+    m_originZ = chunkZ * 16;
+
+    // 27 个子区块各取所需的范围:-1 方向只取最后一层,+1 方向只取第一层
+    for (int sy = -1; sy <= 1; ++sy) {
+        const int yBegin = (sy < 0) ? -1 : (sy == 0 ? 0 : 16);
+        const int yEnd = (sy < 0) ? -1 : (sy == 0 ? 15 : 16);
+        for (int sz = -1; sz <= 1; ++sz) {
+            const int zBegin = (sz < 0) ? -1 : (sz == 0 ? 0 : 16);
+            const int zEnd = (sz < 0) ? -1 : (sz == 0 ? 15 : 16);
+            for (int sx = -1; sx <= 1; ++sx) {
+                const int xBegin = (sx < 0) ? -1 : (sx == 0 ? 0 : 16);
+                const int xEnd = (sx < 0) ? -1 : (sx == 0 ? 15 : 16);
+
+                // 未加载的子区块按 GetBlockId / GetSkyLight 的约定视为空气、光照 0
+                const SectionCacheEntry* section = sectionGrid.FindSection(chunkX + sx, sectionY + sy, chunkZ + sz);
+                for (int ly = yBegin; ly <= yEnd; ++ly) {
+                    for (int lz = zBegin; lz <= zEnd; ++lz) {
+                        for (int lx = xBegin; lx <= xEnd; ++lx) {
+                            const int index = Index(lx, ly, lz);
+                            if (!section) {
+                                m_ids[index] = 0;
+                                m_level[index] = static_cast<int8_t>(blockTraits.Level(0));
+                                m_skyLight[index] = 0;
+                                continue;
+                            }
+                            const int yzx = toYZX(lx & 15, ly & 15, lz & 15);
+                            const int id = section->GetBlock(yzx);
+                            m_ids[index] = static_cast<uint16_t>(id);
+                            m_level[index] = static_cast<int8_t>(blockTraits.Level(id));
+                            m_skyLight[index] = static_cast<int8_t>(section->skyLight.Get(yzx));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void SectionSnapshot::BuildFaceMasks(SectionFaceMasks& masks) const {
+    // 遮挡位平面:含边界的 18x18 列,第 ly + 1 位为 1 表示该方块会遮挡相邻面
+    uint32_t occluder[kSize][kSize];
+    for (int lx = -1; lx <= 16; ++lx) {
+        // 保留边界面时,导出区域外一格的方块不遮挡(与 GetBlockIdWithNeighbors 相同)
+        const int worldX = m_originX + lx;
+        const bool boundaryX = config.keepBoundary && (worldX == config.maxX + 1 || worldX == config.minX - 1);
+        for (int lz = -1; lz <= 16; ++lz) {
+            const int worldZ = m_originZ + lz;
+            const bool boundaryZ = config.keepBoundary && (worldZ == config.maxZ + 1 || worldZ == config.minZ - 1);
+            uint32_t bits = 0;
+            if (!boundaryX && !boundaryZ) {
+                for (int ly = -1; ly <= 16; ++ly) {
+                    bits |= static_cast<uint32_t>(blockTraits.IsSolid(m_ids[Index(lx, ly, lz)])) << (ly + 1);
+                }
+            }
+            occluder[lx + 1][lz + 1] = bits;
+        }
+    }
+
+    // 子区块本身的方块类别
+    for (int lx = 0; lx < 16; ++lx) {
+        for (int lz = 0; lz < 16; ++lz) {
+            uint16_t nonAir = 0;
+            uint16_t fluid = 0;
+            for (int ly = 0; ly < 16; ++ly) {
+                const int index = Index(lx, ly, lz);
+                nonAir |= static_cast<uint16_t>(!blockTraits.IsAir(m_ids[index])) << ly;
+                fluid |= static_cast<uint16_t>(m_level[index] != -1) << ly;
+            }
+            masks.nonAir[SectionFaceMasks::Column(lx, lz)] = nonAir;
+            masks.fluid[SectionFaceMasks::Column(lx, lz)] = fluid;
+        }
+    }
+
+    // 上下方向在列内移位,水平方向取相邻列;每个面只需一次移位和取反
+    for (int lx = 0; lx < 16; ++lx) {
+        for (int lz = 0; lz < 16; ++lz) {
+            const int column = SectionFaceMasks::Column(lx, lz);
+            const uint32_t self = occluder[lx + 1][lz + 1];
+            masks.visible[SectionFaceMasks::kUp][column] = static_cast<uint16_t>(~self >> 2);
+            masks.visible[SectionFaceMasks::kDown][column] = static_cast<uint16_t>(~self);
+            masks.visible[SectionFaceMasks::kWest][column] = static_cast<uint16_t>(~occluder[lx][lz + 1] >> 1);
+            masks.visible[SectionFaceMasks::kEast][column] = static_cast<uint16_t>(~occluder[lx + 2][lz + 1] >> 1);
+            masks.visible[SectionFaceMasks::kNorth][column] = static_cast<uint16_t>(~occluder[lx + 1][lz] >> 1);
+            masks.visible[SectionFaceMasks::kSouth][column] = static_cast<uint16_t>(~occluder[lx + 1][lz + 2] >> 1);
+        }
+    }
+}
+
+int SectionSnapshot::Level(int lx, int ly, int lz) const {
+    const int index = Index(lx, ly, lz);
+    const int currentId = m_ids[index];
+    const int currentLevel = m_level[index];
+
+    // 判断当前方块是否是注册流体或已有level标记
+    if (blockTraits.IsFluid(currentId) || currentLevel == 0) {
+        // 检查上方方块;超出边界时回退到全局查询
+        int upperId = (ly < 16) ? m_ids[Index(lx, ly + 1, lz)]
+            : GetBlockId(m_originX + lx, m_originY + ly + 1, m_originZ + lz);
+        if (blockTraits.IsFluid(upperId) || blockTraits.Level(upperId) == 0) {
+            return 8; // 上方是流体
+        }
+        else {
+            return currentLevel; // 当前流体level
+        }
+    }
+
+    return blockTraits.IsSolid(currentId) ? -2 : -1; // 空气返回-1,固体返回-2
+}
+
+int SectionSnapshot::BlockIdWithNeighbors(int lx, int ly, int lz, bool* neighborIsAir, int* fluidLevels) const {
+    const int index = Index(lx, ly, lz);
+    const int currentId = m_ids[index];
+    const bool hasFluidData = (m_level[index] != -1);
+
+    // 统一处理 neighborIsAir 数组(6个方向,顺序与 GetBlockIdWithNeighbors 一致)
+    if (neighborIsAir != nullptr) {
+        static const int directions[6][3] = {
+            {0, 1, 0},    // 上(Y+)
+            {0, -1, 0},   // 下(Y-)
+            {-1, 0, 0},   // 西(X-)
+            {1, 0, 0},    // 东(X+)
+            {0, 0, -1},   // 北(Z-)
+            {0, 0, 1}     // 南(Z+)
+        };
+
+        for (int i = 0; i < 6; ++i) {
+            const int nlx = lx + directions[i][0];
+            const int nly = ly + directions[i][1];
+            const int nlz = lz + directions[i][2];
+
+            // 如果启用了保留边界面,则直接判断
+            if (config.keepBoundary) {
+                const int nx = m_originX + nlx;
+                const int nz = m_originZ + nlz;
+                if ((nx == config.maxX + 1) || (nx == config.minX - 1) ||
+                    (nz == config.maxZ + 1) || (nz == config.minZ - 1)) {
+                    neighborIsAir[i] = true;
+                    continue;
+                }
+            }
+
+            const int neighborIndex = Index(nlx, nly, nlz);
+            const int neighborId = m_ids[neighborIndex];
+            const bool neighborNonSolid = !blockTraits.IsSolid(neighborId);
+
+            if (hasFluidData) {
+                const int neighborLevel = m_level[neighborIndex];
+                const bool isSameFluid = (blockTraits.BaseNameId(currentId) == blockTraits.BaseNameId(neighborId));
+                const bool neighborIsFluid = blockTraits.IsFluid(neighborId);
+                neighborIsAir[i] = (isSameFluid && (neighborLevel != 0 && neighborLevel != -1)) ||
+                    (neighborLevel != 0 && !neighborIsFluid && neighborNonSolid);
+            }
+            else {
+                neighborIsAir[i] = neighborNonSolid;
+            }
+        }
+    }
+
+    // 处理 fluidLevels 数组,仅在存在流体数据且数组不为空时进行
+    if (hasFluidData && fluidLevels != nullptr) {
+        // 中心块的流体等级
+        fluidLevels[0] = Level(lx, ly, lz);
+        static const int levelDirections[9][3] = {
+            {0, 0, -1},   // 北
+            {0, 0, 1},    // 南
+            {1, 0, 0},    // 东
+            {-1, 0, 0},   // 西
+            {1, 0, -1},   // 东北
+            {-1, 0, -1},  // 西北
+            {1, 0, 1},    // 东南
+            {-1, 0, 1},   // 西南
+            {0, 1, 0}     // 上
+        };
+        for (int i = 0; i < 9; ++i) {
+            fluidLevels[i + 1] = Level(lx + levelDirections[i][0], ly + levelDirections[i][1], lz + levelDirections[i][2]);
+        }
+    }
+
+    return currentId;
+}
@@ -0,0 +1,60 @@
+// SectionSnapshot.h
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// 子区块的面可见性掩码:每列 (lx, lz) 一个 16 位掩码,第 ly 位对应该列中的方块
+// 列下标为 lx * 16 + lz;方向顺序与 GetBlockIdWithNeighbors 的 neighborIsAir 一致
+struct SectionFaceMasks {
+    enum Direction { kUp, kDown, kWest, kEast, kNorth, kSouth, kDirectionCount };
+
+    static int Column(int lx, int lz) { return lx * 16 + lz; }
+
+    // 该方向的相邻方块不遮挡(非 solids 方块,或 keepBoundary 时的导出边界外)
+    std::array<std::array<uint16_t, 256>, kDirectionCount> visible;
+    std::array<uint16_t, 256> nonAir; // 不是 minecraft:air
+    std::array<uint16_t, 256> fluid;  // 含流体(流体本身或含水方块),剔除规则不同,不能只看掩码
+};
+
+// 子区块网格生成的输入:一个子区块加上 26 个相邻子区块的一格边界,共 18x18x18 个方块
+// 生成前一次性从 sectionGrid 复制方块ID、流体等级与天空光照,之后的邻居查询都是固定偏移的数组访问,
+// 不再逐个方块查找区块与子区块。局部坐标范围为 -1..16,0..15 为子区块本身。
+class SectionSnapshot {
+public:
+    static constexpr int kSize = 18;
+    static constexpr int kVolume = kSize * kSize * kSize;
+
+    // 复制 (chunkX, sectionY, chunkZ) 及其边界;调用方需在 EpochGuard 作用域内
+    void Fill(int chunkX, int sectionY, int chunkZ);
+
+    // 子区块最小角的世界坐标
+    int OriginX() const { return m_originX; }
+    int OriginY() const { return m_originY; }
+    int OriginZ() const { return m_originZ; }
+
+    int BlockId(int lx, int ly, int lz) const { return m_ids[Index(lx, ly, lz)]; }
+    int SkyLight(int lx, int ly, int lz) const { return m_skyLight[Index(lx, ly, lz)]; }
+
+    // 与 GetLevel 相同:流体返回 0-8,空气 -1,固体 -2
+    int Level(int lx, int ly, int lz) const;
+
+    // 用位平面一次算出整个子区块各方向的面可见性
+    void BuildFaceMasks(SectionFaceMasks& masks) const;
+
+    // 与 GetBlockIdWithNeighbors 相同,坐标为局部坐标(0..15)
+    int BlockIdWithNeighbors(int lx, int ly, int lz, bool* neighborIsAir = nullptr, int* fluidLevels = nullptr) const;
+
+private:
+    static int Index(int lx, int ly, int lz) {
+        return ((ly + 1) * kSize + (lz + 1)) * kSize + (lx + 1);
+    }
+
+    int m_originX = 0;
+    int m_originY = 0;
+    int m_originZ = 0;
+
+    std::array<uint16_t, kVolume> m_ids;
+    std::array<int8_t, kVolume> m_level;    // 方块本身的流体等级(blockTraits.Level)
+    std::array<int8_t, kVolume> m_skyLight; // 含缺失标记 -1/-2
+};
@@ -0,0 +1,120 @@
+// ShardedInterner.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// 并发的 名称 -> 稳定ID 登记表,全局方块调色板(BlockStateInterner)与全局材质表(MaterialRegistry)共用
+// 查找按名称散列到多个分片,各分片独立加读写锁,已存在的名称只需分片的共享锁;
+// 值存放在只追加的分块数组中,新增不会搬移已有对象,按ID读取无需加锁。
+template <typename Value, size_t MaxCount>
+class ShardedInterner {
+public:
+    static constexpr size_t kShardCount = 16;
+    static constexpr size_t kChunkSize = 1024;
+    static constexpr size_t kMaxCount = MaxCount;
+    static_assert(MaxCount % kChunkSize == 0, "MaxCount 必须是 kChunkSize 的整数倍");
+
+    ShardedInterner() {
+        for (auto& chunk : m_chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~ShardedInterner() {
+        for (auto& chunk : m_chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    // 返回名称对应的ID,不存在时用 args 构造新值;已满时返回 std::nullopt
+    // 新建时先调用 onAdded(id, value) 再让其他线程读到该ID,isNew 不为空时写入本次调用是否新建
+    template <typename OnAdded, typename... Args>
+    std::optional<uint32_t> Intern(const std::string& name, bool* isNew, OnAdded&& onAdded, Args&&... args) {
+        if (isNew) {
+            *isNew = false;
+        }
+        Shard& shard = m_shards[std::hash<std::string>{}(name) % kShardCount];
+
+        // 绝大多数名称已经存在,只需共享锁
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.ids.find(name);
+            if (it != shard.ids.end()) {
+                return it->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.ids.find(name);
+        if (it != shard.ids.end()) {
+            return it->second;
+        }
+
+        uint32_t id;
+        {
+            // 只在新增时持有,保证ID连续分配、m_size 之前的槽位都已构造
+            std::lock_guard<std::mutex> appendLock(m_appendMutex);
+            size_t index = m_size.load(std::memory_order_relaxed);
+            if (index >= MaxCount) {
+                return std::nullopt;
+            }
+
+            std::atomic<std::optional<Value>*>& chunkSlot = m_chunks[index / kChunkSize];
+            std::optional<Value>* chunk = chunkSlot.load(std::memory_order_relaxed);
+            if (!chunk) {
+                chunk = new std::optional<Value>[kChunkSize];
+                chunkSlot.store(chunk, std::memory_order_release);
+            }
+            const Value& value = chunk[index % kChunkSize].emplace(std::forward<Args>(args)...);
+
+            id = static_cast<uint32_t>(index);
+            onAdded(id, value);
+            m_size.store(index + 1, std::memory_order_release);
+        }
+
+        shard.ids.emplace(name, id);
+        if (isNew) {
+            *isNew = true;
+        }
+        return id;
+    }
+
+    // 按ID读取;ID 不小于 Size() 时返回 nullptr
+    const Value* Find(uint32_t id) const {
+        // m_size 之前的槽位都已构造完成,之后不再修改
+        if (id >= Size()) {
+            return nullptr;
+        }
+        const std::optional<Value>* chunk = m_chunks[id / kChunkSize].load(std::memory_order_acquire);
+        return &*chunk[id % kChunkSize];
+    }
+
+    // 已登记的数量,ID 为 [0, Size())
+    size_t Size() const { return m_size.load(std::memory_order_acquire); }
+
+private:
+    ShardedInterner(const ShardedInterner&) = delete;
+    ShardedInterner& operator=(const ShardedInterner&) = delete;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, uint32_t> ids;
+    };
+
+    std::array<Shard, kShardCount> m_shards;
+    // 每块 kChunkSize 个槽位,按需分配,分配后不再移动
+    std::array<std::atomic<std::optional<Value>*>, MaxCount / kChunkSize> m_chunks;
+
+    std::mutex m_appendMutex;
+    std::atomic<size_t> m_size{ 0 };
+};
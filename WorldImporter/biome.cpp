@@ -132,15 +132,15 @@ int GetBiomeId(int blockX, int blockY, int blockZ) {
     int sectionY;
     blockYToSectionY(blockY, sectionY);
 
-    // 创建缓存键
-    auto blockKey = std::make_tuple(chunkX, chunkZ, sectionY);
-
-    // 检查 SectionCache 中是否存在对应的区块数据,如果没有则加载
-    if (sectionCache.find(blockKey) == sectionCache.end()) {
+    // 检查子区块存储中是否存在对应的区块数据,如果没有则加载
+    if (!sectionGrid.HasColumn(chunkX, chunkZ)) {
         LoadAndCacheBlockData(chunkX, chunkZ);
     }
 
-    const auto& biomeData = sectionCache[blockKey].biomeData;
+    const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
+    if (!section) {
+        return 0;
+    }
 
     int biomeX = mod16(blockX) / 4;
     int biomeY = mod16(blockY) / 4;
@@ -150,7 +150,7 @@ int GetBiomeId(int blockX, int blockY, int blockZ) {
     int index = 16 * biomeY + 4 * biomeZ + biomeX;
 
     // 获取并返回群系ID
-    return (index < biomeData.size()) ? biomeData[index] : 0;
+    return section->GetBiome(index);
 }
 
 // 初始化静态成员
@@ -346,15 +346,12 @@ int Biome::GetBiomeColor(int blockX, int blockY, int blockZ, BiomeColorType colo
             int sectionY;
             blockYToSectionY(blockY, sectionY);
 
-            // 创建缓存键
-            auto blockKey = std::make_tuple(chunkX, chunkZ, sectionY);
-
-            // 检查 SectionCache 中是否存在对应的区块数据,否则加载
-            if (sectionCache.find(blockKey) == sectionCache.end()) {
+            // 检查子区块存储中是否存在对应的区块数据,否则加载
+            if (!sectionGrid.HasColumn(chunkX, chunkZ)) {
                 LoadAndCacheBlockData(chunkX, chunkZ);
             }
 
-            const auto& biomeData = sectionCache[blockKey].biomeData;
+            const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
 
             // 计算在子区块内的坐标,注意与生物群系数据排列有关
             int biomeX = mod16(curX) / 4;
@@ -362,8 +359,8 @@ int Biome::GetBiomeColor(int blockX, int blockY, int blockZ, BiomeColorType colo
             int biomeZ = mod16(curZ) / 4;
             int index = 16 * biomeY + 4 * biomeZ + biomeX;
 
-            // 获取生物群系ID(若超出范围,则默认为0)
-            int biomeId = (index < biomeData.size()) ? biomeData[index] : 0;
+            // 获取生物群系ID(子区块不存在时默认为0)
+            int biomeId = section ? section->GetBiome(index) : 0;
 
             // 共享读锁确保 biomeRegistry 的线程安全
             std::shared_lock<std::shared_mutex> lock(registryMutex);
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <climits>
 #include <fstream>
 #include <iostream>
 #include <locale>
@@ -18,6 +19,7 @@
 #include "config.h"
 #include "block.h"
 #include "RegionCache.h"
+#include "RegionPrefetcher.h"
 #include "model.h"
 #include "EntityBlock.h"
 #include "blockstate.h"
@@ -27,30 +29,47 @@
 #include "decompressor.h"
 #include "locutil.h"
 #include "hashutils.h"
+#include "BitUnpack.h"
+#include "chunk.h"
 
 using namespace std;
 
 // --------------------------------------------------------------------------------
 // 文件缓存相关对象
 // --------------------------------------------------------------------------------
-// 统一的缓存表(预留桶数量,减少 rehash)
+// 子区块数据保存在 SectionGrid(sectionGrid)中
+#include <mutex>
 #include <shared_mutex>
 
-// 带读写锁的区块缓存
-std::shared_mutex sectionCacheMutex;
 std::shared_mutex chunkAuxCacheMutex;
-std::unordered_map<std::tuple<int, int, int>, SectionCacheEntry, triple_hash> sectionCache(4096);
 
-// 为 EntityBlockCache 和 heightMapCache 定义新的互斥锁
+// 新方块状态的模型缓存生成串行进行(只在首次遇到某个状态时发生)
+static std::mutex blockstateBuildMutex;
+
+// 为 EntityBlockCache 定义新的互斥锁
 std::shared_mutex entityBlockCacheMutex;
-std::shared_mutex heightMapCacheMutex;
 
-// 实体方块缓存
+// 实体方块缓存(高度图随子区块保存在 ChunkColumn 中)
 std::unordered_map<std::pair<int, int>, std::vector<std::shared_ptr<EntityBlock>>, pair_hash> EntityBlockCache(1024);
-std::unordered_map<std::pair<int, int>, std::unordered_map<std::string, std::vector<int>>, pair_hash> heightMapCache(1024);
 
-std::vector<Block> globalBlockPalette;
+// 为新加入全局调色板的方块状态生成模型缓存
+static void BuildModelsForNewStates(const std::vector<uint32_t>& ids) {
+    if (ids.empty()) return;
+    std::vector<Block> newBlocks;
+    newBlocks.reserve(ids.size());
+    for (uint32_t id : ids) {
+        newBlocks.push_back(*blockStateInterner.Find(id));
+    }
+    {
+        std::lock_guard<std::mutex> lock(blockstateBuildMutex);
+        ProcessBlockstateForBlocks(newBlocks);
+    }
 
+    // 新状态在加入调色板时就烘焙好模型(multipart 的条件匹配与合并在此完成),网格生成时只做查表
+    for (uint32_t id : ids) {
+        bakedModels.Get(static_cast<int>(id));
+    }
+}
 
 // 添加静态邻居偏移数组,避免重复构造
 static const std::array<std::tuple<int, int, int>, 6> kSectionNeighborOffsets = { {
@@ -63,42 +82,33 @@ static const std::array<std::tuple<int, int, int>, 6> kSectionNeighborOffsets =
 // 文件操作相关函数
 // --------------------------------------------------------------------------------
 void UpdateSkyLightNeighborFlags() {
-    std::unordered_map<std::tuple<int, int, int>, bool, triple_hash> needsUpdate;
-
-    {
-        std::shared_lock<std::shared_mutex> readLock(sectionCacheMutex);
-        // 收集需要更新的区块
-        for (const auto& entry : sectionCache) {
-            const auto& key = entry.first;
-            const auto& skyLightData = entry.second.skyLight;
-
-            if (skyLightData.size() == 1 && skyLightData[0] == -1) {
-                needsUpdate[key] = true;
+    // 收集缺少天空光照的子区块
+    std::vector<std::tuple<int, int, int>> needsUpdate;
+    sectionGrid.ForEachColumn([&](int chunkX, int chunkZ, const ChunkColumn& column) {
+        for (size_t i = 0; i < column.sections.size(); ++i) {
+            const SectionLight& skyLight = column.sections[i].skyLight;
+            if (!skyLight.present && skyLight.uniform == -1) {
+                needsUpdate.emplace_back(chunkX, chunkZ, column.minSectionY + static_cast<int>(i));
             }
         }
-    }
+    });
 
-    // 检查邻居,并更新skyLightData为单元素-2
-    for (auto& entry : needsUpdate) {
-        int chunkX = std::get<0>(entry.first);
-        int chunkZ = std::get<1>(entry.first);
-        int sectionY = std::get<2>(entry.first);
+    // 检查邻居,相邻子区块有光照数据时标记为 -2
+    for (const auto& entry : needsUpdate) {
+        int chunkX = std::get<0>(entry);
+        int chunkZ = std::get<1>(entry);
+        int sectionY = std::get<2>(entry);
         bool hasLightNeighbor = false;
-        {
-            std::shared_lock<std::shared_mutex> readLock(sectionCacheMutex);
-            for (const auto& offset : kSectionNeighborOffsets) {
-                auto dir = std::make_tuple(chunkX + std::get<0>(offset), chunkZ + std::get<1>(offset), sectionY + std::get<2>(offset));
-                auto it = sectionCache.find(dir);
-                if (it != sectionCache.end() && it->second.skyLight.size() == 4096) {
-                    hasLightNeighbor = true;
-                    break;
-                }
+        for (const auto& offset : kSectionNeighborOffsets) {
+            const SectionCacheEntry* neighbor = sectionGrid.FindSection(
+                chunkX + std::get<0>(offset), sectionY + std::get<2>(offset), chunkZ + std::get<1>(offset));
+            if (neighbor && neighbor->skyLight.present) {
+                hasLightNeighbor = true;
+                break;
             }
         }
         if (hasLightNeighbor) {
-            std::unique_lock<std::shared_mutex> writeLock(sectionCacheMutex);
-            auto& skyLightData = sectionCache[entry.first].skyLight;
-            skyLightData.assign(1, -2);
+            sectionGrid.FindSection(chunkX, sectionY, chunkZ)->skyLight.uniform = -2;
         }
     }
 }
@@ -106,168 +116,180 @@ void UpdateSkyLightNeighborFlags() {
 // --------------------------------------------------------------------------------
 // 方块相关核心函数
 // --------------------------------------------------------------------------------
-// 新增函数:处理单个子区块
-void ProcessSection(int chunkX, int chunkZ, int sectionY, const NbtTagPtr& sectionTag) {
-    // 获取方块数据
-    auto blo = getBlockStates(sectionTag);
-    std::vector<std::string> blockPalette = getBlockPalette(blo);
-    std::vector<int> blockData = getBlockStatesData(blo, blockPalette);
+// 数组所有元素相同时释放数组,只保留一个值
+static void CollapseUniform(std::vector<uint16_t>& values, uint16_t& uniform) {
+    if (values.empty()) return;
+    const uint16_t first = values[0];
+    for (uint16_t v : values) {
+        if (v != first) return;
+    }
+    uniform = first;
+    std::vector<uint16_t>().swap(values);
+}
 
-    // 转换为全局ID并注册调色板
-    std::vector<int> globalBlockData;
-    globalBlockData.reserve(blockData.size()); // 预分配空间
+// 统计子区块摘要(需在方块数据解包之后调用)
+static void SummarizeSection(SectionCacheEntry& section) {
+    SectionSummary& summary = section.summary;
+    summary = SectionSummary();
+
+    if (section.IsUniform()) {
+        const int id = section.uniformBlock;
+        const bool solid = blockTraits.IsSolid(id);
+        summary.nonAirCount = blockTraits.IsAir(id) ? 0 : 4096;
+        summary.solidCount = solid ? 4096 : 0;
+        summary.solidShell = solid ? 0x3F : 0;
+        summary.hasFluid = blockTraits.Level(id) != -1;
+        return;
+    }
 
-    static std::unordered_map<std::string, int> globalBlockMap; // 预处理全局调色板映射
+    // 实际出现的方块去重后再查询属性;标记数组按线程复用,用完按 distinct 清回
+    thread_local std::vector<bool> seen(BlockTraitsTable::kMaxBlockStates, false);
+    thread_local std::vector<uint16_t> distinct;
+    distinct.clear();
+    for (uint16_t id : section.blockData) {
+        summary.nonAirCount += !blockTraits.IsAir(id);
+        summary.solidCount += blockTraits.IsSolid(id);
+        if (!seen[id]) {
+            seen[id] = true;
+            distinct.push_back(id);
+        }
+    }
+    for (uint16_t id : distinct) {
+        seen[id] = false;
+        summary.hasFluid = summary.hasFluid || blockTraits.Level(id) != -1;
+    }
 
-    // 预处理全局调色板,建立快速查找的映射
-    if (globalBlockMap.empty()) {
-        for (size_t i = 0; i < globalBlockPalette.size(); ++i) {
-            const Block& block = globalBlockPalette[i];
-            if (globalBlockMap.find(block.name) == globalBlockMap.end()) {
-                globalBlockMap[block.name] = static_cast<int>(i);
+    // 六个外层:方向顺序为 上(y=15) 下(y=0) 西(x=0) 东(x=15) 北(z=0) 南(z=15)
+    if (summary.solidCount == 0) return;
+    auto layerSolid = [&](int axis, int value) {
+        for (int a = 0; a < 16; ++a) {
+            for (int b = 0; b < 16; ++b) {
+                // axis 为 0/1/2 时固定 x/y/z 为 value,另外两个坐标取 (a, b)
+                const int x = (axis == 0) ? value : a;
+                const int y = (axis == 1) ? value : (axis == 0 ? a : b);
+                const int z = (axis == 2) ? value : b;
+                if (!blockTraits.IsSolid(section.blockData[toYZX(x, y, z)])) return false;
             }
         }
+        return true;
+    };
+    static const int kShellLayers[6][2] = { {1, 15}, {1, 0}, {0, 0}, {0, 15}, {2, 0}, {2, 15} };
+    for (int d = 0; d < 6; ++d) {
+        if (layerSolid(kShellLayers[d][0], kShellLayers[d][1])) {
+            summary.solidShell |= static_cast<uint8_t>(1u << d);
+        }
     }
+}
 
-    for (int relativeId : blockData) {
-        if (relativeId < 0 || relativeId >= static_cast<int>(blockPalette.size())) {
-            globalBlockData.push_back(0);
-            continue;
-        }
+// 新增函数:处理单个子区块,结果写入 section
+void ProcessSection(const NbtNode* sectionTag, SectionCacheEntry& section) {
+    // 获取方块数据
+    auto blo = getBlockStates(sectionTag);
+    std::vector<std::string> blockPalette = getBlockPalette(blo);
 
-        const std::string& blockName = blockPalette[relativeId];
-        auto it = globalBlockMap.find(blockName);
-        if (it != globalBlockMap.end()) {
-            globalBlockData.push_back(it->second);
-        }
-        else {
-            int idx = static_cast<int>(globalBlockPalette.size());
-            globalBlockPalette.emplace_back(blockName); // 新方块添加到全局调色板
-            globalBlockMap[blockName] = idx;
-            globalBlockData.push_back(idx);
-
-            // 为新添加的方块生成模型缓存
-            std::vector<Block> newBlockVector;
-            newBlockVector.push_back(globalBlockPalette.back()); // 获取刚添加的方块
-            ProcessBlockstateForBlocks(newBlockVector); // 调用处理函数
+    // 局部调色板 -> 16 位全局ID 查找表,长度覆盖位宽能表示的全部索引,越界索引映射为 0
+    // 已存在的状态只在分片上取共享锁,不会阻塞其他线程的解析
+    const int bitsPerState = BitUnpack::BlockStateBits(blockPalette.size());
+    std::vector<uint16_t> paletteToGlobal(size_t(1) << bitsPerState, 0);
+    std::vector<uint32_t> newStates;
+    for (size_t i = 0; i < blockPalette.size(); ++i) {
+        bool isNew = false;
+        uint32_t id = blockStateInterner.Intern(blockPalette[i], &isNew);
+        paletteToGlobal[i] = static_cast<uint16_t>(id);
+        if (isNew) {
+            newStates.push_back(id);
         }
     }
+    BuildModelsForNewStates(newStates);
+
+    // 转换为全局ID:直接解包到最终数组
+    auto blockDataTag = getChildByName(blo, "data");
+    if (blockPalette.size() <= 1 || !blockDataTag || blockDataTag->type != TagType::LONG_ARRAY) {
+        // 单一调色板没有 data 数组,整个子区块为同一方块
+        section.uniformBlock = paletteToGlobal[0];
+    }
+    else {
+        section.blockData.assign(4096, paletteToGlobal[0]);
+        BitUnpack::Unpack(blockDataTag->payload, bitsPerState, 4096, section.blockData.data(),
+            BitUnpack::Lut<uint16_t>{ paletteToGlobal.data() });
+        CollapseUniform(section.blockData, section.uniformBlock);
+    }
+    SummarizeSection(section);
 
     // 获取生物群系数据
     auto bio = getBiomes(sectionTag);
-    std::vector<int> biomeData;
     if (bio) {
         std::vector<std::string> biomePalette = getBiomePalette(bio);
         auto dataTag = getChildByName(bio, "data");
 
-        if (dataTag && dataTag->type == TagType::LONG_ARRAY) {
-            int paletteSize = biomePalette.size();
-            int bitsPerEntry = (paletteSize > 1) ? static_cast<int>(std::ceil(std::log2(paletteSize))) : 1;
-            int entriesPerLong = 64 / bitsPerEntry; // 每个long存储多少个条目
-            int mask = (1 << bitsPerEntry) - 1;
-
-            biomeData.resize(64, 0); // 固定64个生物群系单元
-            int totalProcessed = 0;
-
-            const int64_t* data = reinterpret_cast<const int64_t*>(dataTag->payload.data());
-            size_t dataSize = dataTag->payload.size() / sizeof(int64_t);
-
-            for (size_t i = 0; i < dataSize && totalProcessed < 64; ++i) {
-                int64_t value = reverseEndian(data[i]);
-                for (int pos = 0; pos < entriesPerLong && totalProcessed < 64; ++pos) {
-                    int index = (value >> (pos * bitsPerEntry)) & mask;
-                    if (index < paletteSize) {
-                        biomeData[totalProcessed] = Biome::GetId(biomePalette[index]);
-                    }
-                    totalProcessed++;
-                }
+        if (dataTag && dataTag->type == TagType::LONG_ARRAY && biomePalette.size() > 1) {
+            // 局部调色板 -> 群系ID 查找表,越界索引映射为 0
+            const int bitsPerEntry = BitUnpack::BiomeBits(biomePalette.size());
+            std::vector<uint16_t> paletteToBiome(size_t(1) << bitsPerEntry, 0);
+            for (size_t i = 0; i < biomePalette.size(); ++i) {
+                paletteToBiome[i] = static_cast<uint16_t>(Biome::GetId(biomePalette[i]));
             }
+
+            section.biomeData.assign(64, 0); // 固定64个生物群系单元
+            BitUnpack::Unpack(dataTag->payload, bitsPerEntry, 64, section.biomeData.data(),
+                BitUnpack::Lut<uint16_t>{ paletteToBiome.data() });
+            CollapseUniform(section.biomeData, section.uniformBiome);
         }
         else if (!biomePalette.empty()) {
-            int defaultBid = Biome::GetId(biomePalette[0]);
-            biomeData.assign(64, defaultBid);
+            section.uniformBiome = static_cast<uint16_t>(Biome::GetId(biomePalette[0]));
         }
     }
 
-    // 获取光照数据
-    auto processLightData = [&](const std::string& lightType, std::vector<int>& lightData) {
+    // 获取光照数据:直接保留存档中的半字节打包,整个子区块光照相同时只保存一个值
+    auto processLightData = [&](const std::string& lightType, SectionLight& light) {
         auto lightTag = getChildByName(sectionTag, lightType);
-        if (lightTag && lightTag->type == TagType::BYTE_ARRAY) {
-            // 批量解析,每个原始字节产生2个光照值
-            const auto& rawData = lightTag->payload;
-            size_t rawSize = rawData.size();
-            lightData.resize(4096);
-            size_t pairs = std::fmin(rawSize, size_t(2048));
-            for (size_t i = 0; i < pairs; ++i) {
-                uint8_t byteVal = static_cast<uint8_t>(rawData[i]);
-                lightData[2*i]   = byteVal & 0xF;
-                lightData[2*i+1] = (byteVal >> 4) & 0xF;
-            }
-            if (pairs * 2 < 4096) {
-                std::memset(lightData.data() + pairs * 2, 0, (4096 - pairs * 2) * sizeof(int));
-            }
+        if (!lightTag || lightTag->type != TagType::BYTE_ARRAY) {
+            light.uniform = -1;
+            return;
         }
-        else {
-            lightData = { -1 };
+        light.present = true;
+
+        auto rawData = lightTag->payload;
+        size_t bytes = (std::min)(rawData.size(), size_t(2048));
+        uint8_t first = bytes > 0 ? static_cast<uint8_t>(rawData[0]) : 0;
+        bool uniform = (first & 0xF) == (first >> 4) && (bytes == 2048 || first == 0);
+        for (size_t i = 1; uniform && i < bytes; ++i) {
+            uniform = static_cast<uint8_t>(rawData[i]) == first;
+        }
+        if (uniform) {
+            light.uniform = static_cast<int8_t>(first & 0xF);
+            return;
         }
-    };
 
-    std::vector<int> skyLightData;
-    processLightData("SkyLight", skyLightData);
-    std::vector<int> blockLightData;
-    processLightData("BlockLight", blockLightData);
-
-    // 存储到统一的缓存
-    int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-    sectionCache[blockKey] = {
-        std::move(skyLightData),      // skyLight
-        std::move(blockLightData),    // blockLight
-        std::move(globalBlockData),   // blockData
-        std::move(biomeData),         // biomeData
-        std::move(blockPalette)       // blockPalette
+        light.nibbles.assign(2048, 0); // 数据不足 2048 字节时其余为 0
+        std::memcpy(light.nibbles.data(), rawData.data(), bytes);
     };
+
+    processLightData("SkyLight", section.skyLight);
+    processLightData("BlockLight", section.blockLight);
 }
 
-// 新函数：清理指定 (chunkX, chunkZ) 的所有 sectionCache 条目
+// 新函数：清理指定 (chunkX, chunkZ) 的所有子区块
 void ClearSectionCacheForChunk(int chunkX, int chunkZ) {
-    std::unique_lock<std::shared_mutex> write_lock(sectionCacheMutex);
-    int removed_count = 0;
-    for (auto it = sectionCache.begin(); it != sectionCache.end(); ) {
-        if (std::get<0>(it->first) == chunkX && std::get<1>(it->first) == chunkZ) {
-            // 调试输出：打印将要删除的条目的键
-            // std::cout << "Debug: Attempting to remove sectionCache entry for (" 
-            //           << std::get<0>(it->first) << ", " 
-            //           << std::get<1>(it->first) << ", " 
-            //           << std::get<2>(it->first) << ")" << std::endl;
-            it = sectionCache.erase(it); // erase 返回下一个有效的迭代器
-            removed_count++;
-        }
-        else {
-            ++it;
-        }
-    }
-    if (removed_count > 0) {
-        //std::cout << "Debug: Cleared " << removed_count << " sectionCache entries for chunk (" << chunkX << ", " << chunkZ << ")" << std::endl;
-    }
+    sectionGrid.Erase(chunkX, chunkZ);
 }
 
 // --- 新增辅助函数 ---
 // 解析 littletiles 的 tiles 复合标签,返回一个包含所有 tile 条目的向量
-static std::vector<LittleTilesTileEntry> ParseLittleTilesTiles(const NbtTagPtr& tilesTag) {
+static std::vector<LittleTilesTileEntry> ParseLittleTilesTiles(const NbtNode* tilesTag) {
     std::vector<LittleTilesTileEntry> tileEntries;
     if (!tilesTag || tilesTag->type != TagType::COMPOUND) {
         return tileEntries;
     }
 
     // 遍历 tiles 复合标签中的每个键,例如 "minecraft:granite"、"minecraft:stone"
-    for (const auto& tileGroupTag : tilesTag->children) {
+    for (const NbtNode* tileGroupTag : tilesTag->children()) {
         // 确保子标签类型为 ListTag
         if (tileGroupTag->type != TagType::LIST)
             continue;
 
         // 使用子标签的 name 作为默认的 blockName
-        std::string blockName = tileGroupTag->name;
+        std::string blockName(tileGroupTag->name);
         // 新建一个 tile 条目
         LittleTilesTileEntry tileEntry;
         tileEntry.blockName = blockName;
@@ -275,7 +297,7 @@ static std::vector<LittleTilesTileEntry> ParseLittleTilesTiles(const NbtTagPtr&
         // 标记:第一个 IntArrayTag 作为颜色,其余均作为 box
         bool isFirstArray = true;
         // 遍历 ListTag 下的每个子节点,均为 IntArrayTag
-        for (const auto& intArrayTag : tileGroupTag->children) {
+        for (const NbtNode* intArrayTag : tileGroupTag->children()) {
             if (intArrayTag->type != TagType::INT_ARRAY)
                 continue;
 
@@ -296,7 +318,7 @@ static std::vector<LittleTilesTileEntry> ParseLittleTilesTiles(const NbtTagPtr&
                         };
 
                     // 在 box 处理逻辑里,拿到 intArrayTag->payload
-                    const auto& pl = intArrayTag->payload;
+                    auto pl = intArrayTag->payload;
 
                     unsigned char b0 = pl[3];
                     unsigned char b1 = pl[2];
@@ -334,10 +356,10 @@ static std::vector<LittleTilesTileEntry> ParseLittleTilesTiles(const NbtTagPtr&
     return tileEntries;
 }
 
-void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesTag) {
+void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtNode* blockEntitiesTag) {
     std::vector<std::shared_ptr<EntityBlock>> entityBlocks;
 
-    for (const auto& entityTag : blockEntitiesTag->children) {
+    for (const NbtNode* entityTag : blockEntitiesTag->children()) {
         // 提取基础信息
         auto idTag = getChildByName(entityTag, "id");
         auto xTag = getChildByName(entityTag, "x");
@@ -347,7 +369,7 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
         std::string id;
         int x = 0, y = 0, z = 0;
         if (idTag && idTag->type == TagType::STRING) {
-            id = std::string(idTag->payload.begin(), idTag->payload.end());
+            id = std::string(getStringView(idTag));
         }
         if (xTag && xTag->type == TagType::INT) {
             x = bytesToInt(xTag->payload);
@@ -372,7 +394,7 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
 
             auto blocksTag = getChildByName(entityTag, "Blocks");
             if (blocksTag && blocksTag->type == TagType::LIST) {
-                for (const auto& blockTag : blocksTag->children) {
+                for (const NbtNode* blockTag : blocksTag->children()) {
                     if (blockTag && blockTag->type == TagType::COMPOUND) {
                         YuushyaBlockEntry entry;
 
@@ -382,16 +404,16 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
                             std::string blockName;
                             auto nameTag = getChildByName(blockStateTag, "Name");
                             if (nameTag && nameTag->type == TagType::STRING) {
-                                blockName = std::string(nameTag->payload.begin(), nameTag->payload.end());
+                                blockName = std::string(getStringView(nameTag));
                             }
 
                             // 解析 Properties
                             auto propertiesTag = getChildByName(blockStateTag, "Properties");
                             if (propertiesTag && propertiesTag->type == TagType::COMPOUND) {
                                 std::string propertiesStr;
-                                for (const auto& prop : propertiesTag->children) {
+                                for (const NbtNode* prop : propertiesTag->children()) {
                                     if (!propertiesStr.empty()) propertiesStr += ",";
-                                    propertiesStr += prop->name + ":" + std::string(prop->payload.begin(), prop->payload.end());
+                                    propertiesStr += std::string(prop->name) + ":" + std::string(getStringView(prop));
                                 }
                                 if (!propertiesStr.empty()) {
                                     blockName += "[" + propertiesStr + "]";
@@ -399,16 +421,11 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
                             }
 
                             // 转换为全局 ID
-                            static std::unordered_map<std::string, int> globalBlockMap;
                             if (!blockName.empty()) {
-                                auto it = globalBlockMap.find(blockName);
-                                if (it != globalBlockMap.end()) {
-                                    entry.blockid = it->second;
-                                }
-                                else {
-                                    entry.blockid = static_cast<int>(globalBlockPalette.size());
-                                    globalBlockPalette.emplace_back(blockName);
-                                    globalBlockMap[blockName] = entry.blockid;
+                                bool isNew = false;
+                                entry.blockid = static_cast<int>(blockStateInterner.Intern(blockName, &isNew));
+                                if (isNew) {
+                                    BuildModelsForNewStates({ static_cast<uint32_t>(entry.blockid) });
                                 }
                             }
                         }
@@ -416,21 +433,21 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
                         // 解析其他属性
                         auto showPosTag = getChildByName(blockTag, "ShowPos");
                         if (showPosTag && showPosTag->type == TagType::LIST) {
-                            for (const auto& pos : showPosTag->children) {
+                            for (const NbtNode* pos : showPosTag->children()) {
                                 entry.showPos.push_back(bytesToDouble(pos->payload));
                             }
                         }
 
                         auto showRotationTag = getChildByName(blockTag, "ShowRotation");
                         if (showRotationTag && showRotationTag->type == TagType::LIST) {
-                            for (const auto& rot : showRotationTag->children) {
+                            for (const NbtNode* rot : showRotationTag->children()) {
                                 entry.showRotation.push_back(bytesToFloat(rot->payload));
                             }
                         }
 
                         auto showScalesTag = getChildByName(blockTag, "ShowScales");
                         if (showScalesTag && showScalesTag->type == TagType::LIST) {
-                            for (const auto& scale : showScalesTag->children) {
+                            for (const NbtNode* scale : showScalesTag->children()) {
                                 entry.showScales.push_back(bytesToFloat(scale->payload));
                             }
                         }
@@ -481,7 +498,7 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
                 // 解析 children 列表
                 auto childrenTag = getChildByName(contentTag, "children");
                 if (childrenTag && childrenTag->type == TagType::LIST) {
-                    for (const auto& childCompoundTag : childrenTag->children) {
+                    for (const NbtNode* childCompoundTag : childrenTag->children()) {
                         if (childCompoundTag && childCompoundTag->type == TagType::COMPOUND) {
                             LittleTilesChildEntry childEntry;
 
@@ -522,53 +539,34 @@ void ProcessEntityBlocks(int chunkX, int chunkZ, const NbtTagPtr& blockEntitiesT
 }
 
 
-// 修改 LoadAndCacheBlockData,使其处理整个 chunk 的所有子区块
-void LoadAndCacheBlockData(int chunkX, int chunkZ) {
-    auto key = std::make_tuple(chunkX, chunkZ, 0);
-    {
-        std::shared_lock<std::shared_mutex> read_lock(sectionCacheMutex);
-        if (sectionCache.find(key) != sectionCache.end()) return;
-    }
-    std::unique_lock<std::shared_mutex> write_lock(sectionCacheMutex);
-    if (sectionCache.find(key) != sectionCache.end()) return;
-    // 计算区域坐标
-    int regionX, regionZ;
-    chunkToRegion(chunkX, chunkZ, regionX, regionZ);
-
-    // 获取区域数据
-    const auto& regionData = GetRegionFromCache(regionX, regionZ);
+// 解析区块 NBT 到 column;数据损坏时 readTag 等会抛出异常,由调用方处理
+static void ParseChunkColumn(int chunkX, int chunkZ, std::span<const char> chunkData, ChunkColumn& column) {
+    // 只提取用到的标签,Entities/structures/PostProcessing/ticks 等子树按长度前缀跳过
+    static const NbtSchema chunkSchema = {
+        "Heightmaps",
+        "block_entities",
+        "sections/Y",
+        "sections/block_states",
+        "sections/biomes",
+        "sections/SkyLight",
+        "sections/BlockLight",
+    };
 
-    // 获取区块数据
-    std::vector<char> chunkData = GetChunkNBTData(regionData, chunkX, chunkZ);
-    // 如果数据为空，表示区块文件不存在或读取失败，直接跳过并缓存空条目
-    if (chunkData.empty()) {
-        std::cerr << "警告: 无法加载区块 (" << chunkX << "," << chunkZ << ")，已跳过。" << std::endl;
-        sectionCache[key] = SectionCacheEntry();
-        return;
-    }
+    // 节点分配在线程内存池中,名称与负载直接指向 chunkData
+    NbtArena& arena = NbtArena::ForThread();
+    arena.Reset();
     size_t index = 0;
-    auto tag = readTag(chunkData, index);
+    const NbtNode* tag = readTag(chunkData, index, arena, chunkSchema);
 
-    auto yPosTag = getChildByName(tag, "yPos");
-    if (yPosTag && yPosTag->type == TagType::INT) {
-        minSectionY = bytesToInt(yPosTag->payload);
-    }
     // 处理高度图
     auto heightMapsTag = getChildByName(tag, "Heightmaps");
     if (heightMapsTag && heightMapsTag->type == TagType::COMPOUND) {
-        std::unique_lock<std::shared_mutex> hm_lock(heightMapCacheMutex); // 加锁
-        for (const auto& mapType : mapTypes) {
-            auto mapDataTag = getChildByName(heightMapsTag, mapType);
+        for (size_t i = 0; i < mapTypes.size(); ++i) {
+            auto mapDataTag = getChildByName(heightMapsTag, mapTypes[i]);
             if (mapDataTag && mapDataTag->type == TagType::LONG_ARRAY) {
-                size_t numLongs = mapDataTag->payload.size() / sizeof(int64_t);
-                const int64_t* rawData = reinterpret_cast<const int64_t*>(mapDataTag->payload.data());
-                std::vector<int64_t> longData(rawData, rawData + numLongs);
-
-                std::vector<int> heights = DecodeHeightMap(longData);
-                heightMapCache[std::make_pair(chunkX, chunkZ)][mapType] = heights;
+                column.heightMaps[i] = DecodeHeightMap(mapDataTag->payload);
             }
         }
-        // hm_lock 在此处自动解锁
     }
     //提取实体方块
     auto blockEntitiesTag = getChildByName(tag, "block_entities");
@@ -582,17 +580,87 @@ void LoadAndCacheBlockData(int chunkX, int chunkZ) {
         return; // 没有子区块
     }
 
-    // 遍历所有子区块
-    for (const auto& sectionTag : sectionsTag->children) {
-        int sectionY = -1;
+    auto readSectionY = [](const NbtNode* sectionTag) {
         auto yTag = getChildByName(sectionTag, "Y");
-        
-        if (yTag && yTag->type == TagType::BYTE) {
-            sectionY = static_cast<int>(yTag->payload[0]);
-        }
+        return (yTag && yTag->type == TagType::BYTE) ? static_cast<int>(yTag->payload[0]) : -1;
+    };
+
+    // 先确定子区块的 Y 范围,按 sectionY - minSectionY 连续存放
+    int minY = INT_MAX, maxY = INT_MIN;
+    for (const NbtNode* sectionTag : sectionsTag->children()) {
+        int sectionY = readSectionY(sectionTag);
+        minY = (std::min)(minY, sectionY);
+        maxY = (std::max)(maxY, sectionY);
+    }
+    if (minY <= maxY) {
+        column.minSectionY = minY;
+        column.sections.resize(static_cast<size_t>(maxY - minY + 1));
+    }
+
+    // 遍历所有子区块
+    for (const NbtNode* sectionTag : sectionsTag->children()) {
+        int sectionY = readSectionY(sectionTag);
 
         // 处理子区块
-        ProcessSection(chunkX, chunkZ, sectionY, sectionTag);
+        ProcessSection(sectionTag, *column.GetSection(sectionY));
+    }
+
+    // 标记含实体方块的子区块
+    {
+        std::shared_lock<std::shared_mutex> lock(entityBlockCacheMutex);
+        auto it = EntityBlockCache.find(std::make_pair(chunkX, chunkZ));
+        if (it != EntityBlockCache.end()) {
+            column.hasEntityBlocks = !it->second.empty();
+            for (const auto& entity : it->second) {
+                int entitySectionY;
+                blockYToSectionY(entity->y, entitySectionY);
+                if (SectionCacheEntry* section = column.GetSection(entitySectionY)) {
+                    section->summary.hasEntityBlocks = true;
+                }
+            }
+        }
+    }
+}
+
+// 修改 LoadAndCacheBlockData,使其处理整个 chunk 的所有子区块
+void LoadAndCacheBlockData(int chunkX, int chunkZ) {
+    // 同一区块只由一个线程解析,其他线程等待其发布
+    if (!sectionGrid.BeginLoad(chunkX, chunkZ)) return;
+
+    // 区块解析到私有的 ChunkColumn 中,不持有任何全局锁;
+    // 任何返回路径(包括失败和异常)都会发布结果,避免等待的线程永久阻塞
+    struct PublishGuard {
+        int chunkX, chunkZ;
+        std::unique_ptr<ChunkColumn> column = std::make_unique<ChunkColumn>();
+        ~PublishGuard() { sectionGrid.PublishColumn(chunkX, chunkZ, std::move(column)); }
+    } publish{ chunkX, chunkZ };
+    ChunkColumn& column = *publish.column;
+
+    // 计算区域坐标
+    int regionX, regionZ;
+    chunkToRegion(chunkX, chunkZ, regionX, regionZ);
+
+    // 获取区域数据
+    auto region = GetRegionFromCache(regionX, regionZ);
+
+    // 获取区块数据(每个线程复用同一个解压缓冲区)
+    thread_local ByteBuffer chunkData;
+    const bool read = region && GetChunkNBTData(*region, chunkX, chunkZ, chunkData);
+    // 区块字节已读取,归还其占用的预读预算
+    RegionPrefetcher::GetInstance().OnChunkConsumed(chunkX, chunkZ);
+    // 如果数据为空，表示区块文件不存在或读取失败，直接跳过并缓存空区块
+    if (!read || chunkData.empty()) {
+        std::cerr << "警告: 无法加载区块 (" << chunkX << "," << chunkZ << ")，已跳过。" << std::endl;
+        return;
+    }
+    try {
+        ParseChunkColumn(chunkX, chunkZ, chunkData, column);
+    } catch (const std::exception& e) {
+        // 单个损坏的区块不应终止整个导出:丢弃解析到一半的数据,按空区块发布
+        std::cerr << "警告: 区块 (" << chunkX << "," << chunkZ << ") 数据损坏，已跳过: " << e.what() << std::endl;
+        publish.column = std::make_unique<ChunkColumn>();
+        std::unique_lock<std::shared_mutex> lock(entityBlockCacheMutex);
+        EntityBlockCache.erase(std::make_pair(chunkX, chunkZ));
     }
 }
 
@@ -606,29 +674,20 @@ int GetBlockId(int blockX, int blockY, int blockZ) {
 
     int sectionY;
     blockYToSectionY(blockY, sectionY);
-    int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-    auto it = sectionCache.find(blockKey);
-    if (it == sectionCache.end()) {
+    const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
+    if (!section) {
         return 0; // 区块未预加载，返回空气
     }
-    const auto& blockData = it->second.blockData;
     int relativeX = mod16(blockX);
     int relativeY = mod16(blockY);
     int relativeZ = mod16(blockZ);
-    int yzx = toYZX(relativeX, relativeY, relativeZ);
-
-    return (yzx < blockData.size()) ? blockData[yzx] : 0;
+    return section->GetBlock(toYZX(relativeX, relativeY, relativeZ));
 }
 
 // 获取方块ID时同时获取相邻方块的air状态,返回当前方块ID
 int GetBlockIdWithNeighbors(int blockX, int blockY, int blockZ, bool* neighborIsAir, int* fluidLevels) {
     int currentId = GetBlockId(blockX, blockY, blockZ);
-    Block currentBlock = GetBlockById(currentId);
-    std::string currentBaseName = currentBlock.GetNameAndNameSpaceWithoutState();
-
-    bool isFluid = fluidDefinitions.find(currentBaseName) != fluidDefinitions.end();
-    bool hasFluidData = (currentBlock.level != -1);
+    bool hasFluidData = (blockTraits.Level(currentId) != -1);
 
     // 统一处理 neighborIsAir 数组(6个方向)
     if (neighborIsAir != nullptr) {
@@ -657,17 +716,17 @@ int GetBlockIdWithNeighbors(int blockX, int blockY, int blockZ, bool* neighborIs
             }
 
             int neighborId = GetBlockId(nx, ny, nz);
-            Block neighborBlock = GetBlockById(neighborId);
+            bool neighborNonSolid = !blockTraits.IsSolid(neighborId);
 
             if (hasFluidData) {
-                std::string neighborBase = neighborBlock.GetNameAndNameSpaceWithoutState();
-                bool isSameFluid = (currentBaseName == neighborBase);
-                bool neighborIsFluid = (fluidDefinitions.find(neighborBase) != fluidDefinitions.end());
-                neighborIsAir[i] = (isSameFluid && (neighborBlock.level != 0 && neighborBlock.level != -1)) ||
-                    (neighborBlock.level != 0 && !neighborIsFluid && neighborBlock.air);
+                int neighborLevel = blockTraits.Level(neighborId);
+                bool isSameFluid = (blockTraits.BaseNameId(currentId) == blockTraits.BaseNameId(neighborId));
+                bool neighborIsFluid = blockTraits.IsFluid(neighborId);
+                neighborIsAir[i] = (isSameFluid && (neighborLevel != 0 && neighborLevel != -1)) ||
+                    (neighborLevel != 0 && !neighborIsFluid && neighborNonSolid);
             }
             else {
-                neighborIsAir[i] = neighborBlock.air;
+                neighborIsAir[i] = neighborNonSolid;
             }
         }
     }
@@ -705,57 +764,48 @@ int GetHeightMapY(int blockX, int blockZ, const std::string& heightMapType) {
     // 触发区块加载(确保高度图数据存在)
     GetBlockId(blockX, 0, blockZ); // Y坐标任意,只为触发加载
 
-    // 查找缓存
-    auto chunkKey = std::make_pair(chunkX, chunkZ);
-    std::shared_lock<std::shared_mutex> lock(heightMapCacheMutex); // 使用读锁
-    auto chunkIter = heightMapCache.find(chunkKey);
-    if (chunkIter == heightMapCache.end()) {
-        return -1; // 区块未加载或高度图未缓存
+    // 查找区块(无锁读取,调用方在 EpochGuard 内)
+    const ChunkColumn* column = sectionGrid.FindColumn(chunkX, chunkZ);
+    if (!column) {
+        return -1; // 区块未加载
     }
 
     // 获取指定类型的高度图
-    auto& typeMap = chunkIter->second;
-    auto typeIter = typeMap.find(heightMapType);
-    if (typeIter == typeMap.end()) {
+    auto typeIter = std::find(mapTypes.begin(), mapTypes.end(), heightMapType);
+    if (typeIter == mapTypes.end()) {
         return -2; // 类型不存在
     }
+    const std::vector<int>& heights = column->heightMaps[typeIter - mapTypes.begin()];
+    if (heights.empty()) {
+        return -2; // 高度图未保存
+    }
 
     // 计算局部坐标
     int localX = mod16(blockX);
     int localZ = mod16(blockZ);
     int index = localX + localZ * 16;
-    
+
     // 返回高度值
-    int result = (index < 256 && index < typeIter->second.size()) ? typeIter->second[index] : -1;
-    // lock 在此处自动解锁
-    return result;
+    return (static_cast<size_t>(index) < heights.size()) ? heights[index] : -1;
 }
 
 int GetLevel(int blockX, int blockY, int blockZ) {
     int currentId = GetBlockId(blockX, blockY, blockZ);
-    Block currentBlock = GetBlockById(currentId);
-    std::string baseName = currentBlock.GetNameAndNameSpaceWithoutState(); // 获取带命名空间的完整名称
 
     // 判断当前方块是否是注册流体或已有level标记
-    bool isFluid = fluidDefinitions.find(baseName) != fluidDefinitions.end();
-
-    if (isFluid || currentBlock.level == 0) {
+    int currentLevel = blockTraits.Level(currentId);
+    if (blockTraits.IsFluid(currentId) || currentLevel == 0) {
         // 检查上方方块
         int upperId = GetBlockId(blockX, blockY + 1, blockZ);
-        Block upperBlock = GetBlockById(upperId);
-        std::string upperBaseName = upperBlock.GetNameAndNameSpaceWithoutState();
-
-        bool upperIsFluid = fluidDefinitions.find(upperBaseName) != fluidDefinitions.end();
-
-        if (upperIsFluid || upperBlock.level == 0) {
+        if (blockTraits.IsFluid(upperId) || blockTraits.Level(upperId) == 0) {
             return 8; // 上方是流体
         }
         else {
-            return currentBlock.level; // 当前流体level
+            return currentLevel; // 当前流体level
         }
     }
 
-    return currentBlock.air ? -1 : -2; // 空气返回-1,固体返回-2
+    return blockTraits.IsSolid(currentId) ? -2 : -1; // 空气返回-1,固体返回-2
 }
 
 int GetSkyLight(int blockX, int blockY, int blockZ) {
@@ -764,25 +814,15 @@ int GetSkyLight(int blockX, int blockY, int blockZ) {
 
     int sectionY;
     blockYToSectionY(blockY, sectionY);
-    int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-
-    auto it = sectionCache.find(blockKey);
-    if (it == sectionCache.end()) {
+    const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
+    if (!section) {
         return 0; // 区块未预加载，返回默认天空光照0
     }
-    const auto& skyLightData = it->second.skyLight;
-
-    if (skyLightData.size() == 1) {
-        return skyLightData[0]; // 标记为-1或-2
-    }
-
+    // 缺失光照时返回标记 -1 或 -2
     int relativeX = mod16(blockX);
     int relativeY = mod16(blockY);
     int relativeZ = mod16(blockZ);
-    int yzx = toYZX(relativeX, relativeY, relativeZ);
-
-    return (yzx < skyLightData.size()) ? skyLightData[yzx] : 0;
+    return section->skyLight.Get(toYZX(relativeX, relativeY, relativeZ));
 }
 
 int GetBlockLight(int blockX, int blockY, int blockZ) {
@@ -791,30 +831,21 @@ int GetBlockLight(int blockX, int blockY, int blockZ) {
 
     int sectionY;
     blockYToSectionY(blockY, sectionY);
-    int adjustedSectionY = AdjustSectionY(sectionY);
-    auto blockKey = std::make_tuple(chunkX, chunkZ, adjustedSectionY);
-
-    auto it = sectionCache.find(blockKey);
-    if (it == sectionCache.end()) {
+    const SectionCacheEntry* section = sectionGrid.FindSection(chunkX, sectionY, chunkZ);
+    if (!section) {
         return 0; // 区块未预加载，返回默认方块光照0
     }
-    const auto& blockLightData = it->second.blockLight;
-
-    if (blockLightData.size() == 1) {
-        return blockLightData[0]; // 标记为-1或-2
-    }
-
+    // 缺失光照时返回标记 -1 或 -2
     int relativeX = mod16(blockX);
     int relativeY = mod16(blockY);
     int relativeZ = mod16(blockZ);
-    int yzx = toYZX(relativeX, relativeY, relativeZ);
-
-    return (yzx < blockLightData.size()) ? blockLightData[yzx] : 0;
+    return section->blockLight.Get(toYZX(relativeX, relativeY, relativeZ));
 }
 
 Block GetBlockById(int blockId) {
-    if (blockId >= 0 && blockId < globalBlockPalette.size()) {
-        return globalBlockPalette[blockId];
+    const Block* block = (blockId >= 0) ? blockStateInterner.Find(static_cast<uint32_t>(blockId)) : nullptr;
+    if (block) {
+        return *block;
     } else {
         return Block("minecraft:air", true);
     }
@@ -825,10 +856,16 @@ Block GetBlockById(int blockId) {
 // 全局方块配置相关函数
 // --------------------------------------------------------------------------------
 void InitializeGlobalBlockPalette() {
-    globalBlockPalette.emplace_back(Block("minecraft:air"));
+    blockStateInterner.Intern("minecraft:air");
 }
 
 std::vector<Block> GetGlobalBlockPalette() {
-    return globalBlockPalette;
+    // ID 连续分配,逐个读取即可,无需复制整个表再加锁
+    std::vector<Block> palette;
+    const size_t count = blockStateInterner.Size();
+    palette.reserve(count);
+    for (size_t id = 0; id < count; ++id) {
+        palette.push_back(*blockStateInterner.Find(static_cast<uint32_t>(id)));
+    }
+    return palette;
 }
-
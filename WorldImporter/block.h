@@ -22,11 +22,13 @@
 #include "hashutils.h"
 #include "fluid.h"
 #include "GlobalCache.h"
+#include "SectionGrid.h"
+#include "BlockTraits.h"
+#include "BlockStateInterner.h"
 extern Config config;
 
 // 内存监控相关的 extern 声明
 extern std::shared_mutex entityBlockCacheMutex; // 新增 EntityBlockCache 的互斥锁
-extern std::shared_mutex heightMapCacheMutex;   // 新增 heightMapCache 的互斥锁
 
 // 缓存的 extern 声明，以便 MemoryMonitor 可以访问
 // 类型定义直接使用 MemoryMonitor.h 中的别名以确保一致性，
@@ -39,13 +41,10 @@ extern std::shared_mutex heightMapCacheMutex;   // 新增 heightMapCache 的互
 // #include "MemoryMonitor.h" // 可以考虑包含这个，但可能导致循环依赖，取决于 MemoryMonitor.h 是否也需要 block.h
 // 如果不包含 MemoryMonitor.h，需要确保以下类型与 MemoryMonitor.h 中的别名以及 block.cpp 中的实际类型一致
 
-// 假设 EntityBlock 和 SectionCacheEntry 等已在此文件或其包含的头文件中定义
+// 假设 EntityBlock 等已在此文件或其包含的头文件中定义
 class EntityBlock; // 前向声明或确保 EntityBlock.h 已被包含
-struct SectionCacheEntry; // 确保 SectionCacheEntry 已定义
 
 extern std::unordered_map<std::pair<int, int>, std::vector<std::shared_ptr<EntityBlock>>, pair_hash> EntityBlockCache;
-extern std::unordered_map<std::pair<int, int>, std::unordered_map<std::string, std::vector<int>>, pair_hash> heightMapCache;
-extern std::unordered_map<std::tuple<int, int, int>, SectionCacheEntry, triple_hash> sectionCache;
 
 struct Block {
     std::string name;
@@ -402,26 +401,11 @@ struct Block {
     }
 };
 
-struct SectionCacheEntry {
-    // 把频繁访问的大数组放在前面,减少访存跨缓存行
-    std::vector<int> skyLight;      // 天空光照数据
-    std::vector<int> blockLight;    // 方块光照数据
-    std::vector<int> blockData;     // 方块数据
-    std::vector<int> biomeData;     // 生物群系数据
-    std::vector<std::string> blockPalette; // 方块调色板 (相对较小)
-};
-
-extern std::vector<Block> globalBlockPalette;
-extern std::unordered_map<std::tuple<int, int, int>, SectionCacheEntry, triple_hash> sectionCache;
-extern std::unordered_map<std::pair<int, int>, std::unordered_map<std::string, std::vector<int>>, pair_hash> heightMapCache;
-
-// 全局读写锁:保护 sectionCache 线程安全
-extern std::shared_mutex sectionCacheMutex;
 
-// 保护 EntityBlockCache 与 heightMapCache 的读写
+// 保护 EntityBlockCache 的读写
 extern std::shared_mutex chunkAuxCacheMutex;
 
-// 高度图类型
+// 高度图类型(下标即 ChunkColumn::heightMaps 的下标)
 static const std::vector<std::string> mapTypes = {"MOTION_BLOCKING", "MOTION_BLOCKING_NO_LEAVES",   "OCEAN_FLOOR", "WORLD_SURFACE"};
 
 void LoadAndCacheBlockData(int chunkX, int chunkZ);
@@ -443,10 +427,10 @@ int GetHeightMapY(int blockX, int blockZ, const std::string& heightMapType);
 
 void ClearSectionCacheForChunk(int chunkX, int chunkZ);
 
-// 获取方块名称转换为Block对象
+// 获取方块名称转换为Block对象(热路径请使用 blockTraits 或 blockStateInterner.Find,避免拷贝)
 Block GetBlockById(int blockId);
 
-// 返回全局的block对照表(Block对象)
+// 返回全局的block对照表(Block对象)的副本
 std::vector<Block> GetGlobalBlockPalette();
 
 
@@ -16,7 +16,7 @@ std::unordered_map<std::string, std::unordered_map<std::string, ModelData>> Bloc
 
 std::unordered_map<std::string,std::unordered_map<std::string,std::vector<WeightedModelData>>> VariantModelCache;
 
-std::unordered_map<std::string,std::unordered_map<std::string,std::vector<std::vector<WeightedModelData>>>> MultipartModelCache;
+std::unordered_map<std::string,std::unordered_map<std::string,std::vector<ModelData>>> MultipartMergedCache;
 
 // 将互斥锁类型更改为 std::shared_mutex
 std::shared_mutex blockstateCachesMutex;
@@ -215,18 +215,29 @@ nlohmann::json GetBlockstateJson(const std::string& namespaceName, const std::st
 // --------------------------------------------------------------------------------
 // 方块状态 JSON 处理
 // --------------------------------------------------------------------------------
+// 在 命名空间 -> 方块ID 两层缓存中查找,找不到时返回 nullptr
+// 调用方持有 blockstateCachesMutex 的共享锁,因此只能用 find(operator[] 会插入新元素)
+template <typename Cache>
+static const typename Cache::mapped_type::mapped_type* FindInCache(const Cache& cache,
+    const std::string& namespaceName, const std::string& blockId) {
+    auto nsIt = cache.find(namespaceName);
+    if (nsIt == cache.end()) {
+        return nullptr;
+    }
+    auto it = nsIt->second.find(blockId);
+    return (it != nsIt->second.end()) ? &it->second : nullptr;
+}
+
 ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::string& blockId) {
     std::shared_lock<std::shared_mutex> lock(blockstateCachesMutex); // 使用 shared_lock 进行读操作
     // 先检查主缓存
-    if (BlockModelCache.count(namespaceName) &&
-        BlockModelCache[namespaceName].count(blockId)) {
-        return BlockModelCache[namespaceName][blockId];
+    if (const ModelData* model = FindInCache(BlockModelCache, namespaceName, blockId)) {
+        return *model;
     }
     
     // 检查 variant 缓存
-    if (VariantModelCache.count(namespaceName) &&
-        VariantModelCache[namespaceName].count(blockId)) {
-        auto& models = VariantModelCache[namespaceName][blockId];
+    if (const auto* variants = FindInCache(VariantModelCache, namespaceName, blockId)) {
+        const auto& models = *variants;
         int totalWeight = 0;
         for (const auto& wm : models) {
             totalWeight += wm.weight;
@@ -247,44 +258,95 @@ ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::s
 
     }
 
-    // 检查 multipart 缓存:在 multipart 时只进行一次随机,
-    // 对每个组选取对应位置的模型(如果该位置没有则使用第一个)
-    if (MultipartModelCache.count(namespaceName) &&
-        MultipartModelCache[namespaceName].count(blockId)) {
-        auto& partList = MultipartModelCache[namespaceName][blockId];
-
-        // 计算所有组中模型数的最大值作为随机索引的范围
-        size_t maxCount = 0;
-        for (const auto& parts : partList) {
-            if (parts.size() > maxCount) {
-                maxCount = parts.size();
-            }
-        }
-        if (maxCount == 0) {
+    // 检查 multipart 缓存:合并结果已在 ProcessBlockstate 中按随机位置预先算好,这里只做一次随机
+    // 已烘焙的方块状态的合并结果移到了 BakedModel 中,这里会未命中,调用方重新处理 blockstate 即可
+    if (const auto* mergedList = FindInCache(MultipartMergedCache, namespaceName, blockId)) {
+        if (mergedList->empty()) {
             return ModelData();
         }
-
         thread_local static std::mt19937 gen_multi(std::random_device{}()); // 为 multipart 使用单独的 thread_local 生成器
-        std::uniform_int_distribution<> dis(0, maxCount - 1);
-        int randomIndex = dis(gen_multi);
+        std::uniform_int_distribution<> dis(0, static_cast<int>(mergedList->size()) - 1);
+        return (*mergedList)[dis(gen_multi)];
+    }
+
+    // 返回空模型
+    return ModelData();
+}
 
+// 对 multipart 的每个随机位置合并一次所有匹配的部件,各组没有该位置时使用第一个
+static std::vector<ModelData> MergeMultipartCombinations(const std::vector<std::vector<WeightedModelData>>& partList) {
+    size_t maxCount = 0;
+    for (const auto& group : partList) {
+        maxCount = (std::max)(maxCount, group.size());
+    }
+
+    std::vector<ModelData> combinations;
+    combinations.reserve(maxCount);
+    for (size_t index = 0; index < maxCount; ++index) {
         ModelData merged;
-        for (auto& parts : partList) {
-            int index = randomIndex;
-            if (index >= parts.size()) {
-                index = 0; // 如果当前组中没有该位置的模型,则默认选第一个
+        for (const auto& group : partList) {
+            if (group.empty()) continue;
+            merged = MergeModelData(merged, group[index < group.size() ? index : 0].model);
+        }
+        combinations.push_back(std::move(merged));
+    }
+    return combinations;
+}
+
+static bool HasUncullableFace(const ModelData& model) {
+    for (const auto& face : model.faces) {
+        if (face.faceDirection == FaceType::DO_NOT_CULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+BakedModel BakeModelFromCache(const std::string& namespaceName, const std::string& blockId) {
+    BakedModel baked;
+    std::unique_lock<std::shared_mutex> lock(blockstateCachesMutex); // multipart 的合并结果会被移出缓存
+
+    // 查找顺序与 GetRandomModelFromCache 一致
+    if (const ModelData* model = FindInCache(BlockModelCache, namespaceName, blockId)) {
+        baked.variants.push_back(*model);
+        baked.cumulativeWeights.push_back(1);
+    }
+
+    if (baked.variants.empty()) {
+        if (const auto* variants = FindInCache(VariantModelCache, namespaceName, blockId)) {
+            int cumulative = 0;
+            for (const auto& wm : *variants) {
+                if (wm.weight <= 0) continue;
+                cumulative += wm.weight;
+                baked.variants.push_back(wm.model);
+                baked.cumulativeWeights.push_back(cumulative);
             }
-            merged = MergeModelData(merged, parts[index].model);
         }
-        return merged;
     }
 
-    // 返回空模型
-    return ModelData();
+    if (baked.variants.empty()) {
+        auto nsIt = MultipartMergedCache.find(namespaceName);
+        if (nsIt != MultipartMergedCache.end()) {
+            auto it = nsIt->second.find(blockId);
+            if (it != nsIt->second.end()) {
+                // 合并结果只由烘焙模型持有,不再在缓存中保留一份;各随机位置等权重
+                baked.variants = std::move(it->second);
+                nsIt->second.erase(it);
+                for (size_t i = 1; i <= baked.variants.size(); ++i) {
+                    baked.cumulativeWeights.push_back(static_cast<int>(i));
+                }
+            }
+        }
+    }
+
+    for (const auto& model : baked.variants) {
+        baked.hasUncullableFaces = baked.hasUncullableFaces || HasUncullableFace(model);
+    }
+    return baked;
 }
 
 // 此方法会处理对应的json文件 
-// 然后计算出方块的模型数据存储在BlockModelCache / VariantModelCache / MultipartModelCache 里面
+// 然后计算出方块的模型数据存储在BlockModelCache / VariantModelCache / MultipartMergedCache 里面
 // 你可以使用 GetRandomModelFromCache 方法来获取模型
 void ProcessBlockstate(const std::string& namespaceName, const std::vector<std::string>& blockIds) {
     for (const auto& blockId : blockIds) {
@@ -512,10 +574,13 @@ void ProcessBlockstate(const std::string& namespaceName, const std::vector<std::
                         multipartModelsList.push_back(multipartModels);
                     }
                 }
-                // 存入 MultipartModelCache
+                // 条件只在这里匹配一次,合并也只在这里做一次,之后按状态直接取用
+                std::vector<ModelData> mergedList = MergeMultipartCombinations(multipartModelsList);
+
+                // 存入 MultipartMergedCache(各部件只用于合并,不再单独缓存)
                 {
                     std::unique_lock<std::shared_mutex> lock(blockstateCachesMutex); // 使用 unique_lock 进行写操作
-                    MultipartModelCache[namespaceName][blockId] = multipartModelsList;
+                    MultipartMergedCache[namespaceName][blockId] = std::move(mergedList);
                 }
             }
             else {
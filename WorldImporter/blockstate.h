@@ -9,6 +9,7 @@
 #include <iostream>
 #include "include/json.hpp"
 #include "model.h"
+#include "BakedModel.h"
 #include "block.h"
 #include "config.h"
 #include "JarReader.h"
@@ -30,7 +31,7 @@ extern std::unordered_map<std::string,
 
 extern std::unordered_map<std::string,
     std::unordered_map<std::string,
-    std::vector<std::vector<WeightedModelData>>>> MultipartModelCache; // multipart部件缓存
+    std::vector<ModelData>>> MultipartMergedCache; // multipart按随机位置预合并的结果,烘焙时移入 BakedModel
 
 bool matchConditions(const std::unordered_map<std::string, std::string>& blockConditions, const nlohmann::json& when);
 
@@ -48,6 +49,10 @@ nlohmann::json GetBlockstateJson(const std::string& namespaceName,const std::str
 
 ModelData GetRandomModelFromCache(const std::string& namespaceName, const std::string& blockId);
 
+// 把缓存中该方块的全部候选模型烘焙为 BakedModel(供 BakedModelRegistry 使用)
+// multipart 的合并结果会移入 BakedModel,同一方块只能烘焙一次
+BakedModel BakeModelFromCache(const std::string& namespaceName, const std::string& blockId);
+
 
 
 #endif // BLOCKSTATE_H
\ No newline at end of file
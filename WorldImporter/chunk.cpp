@@ -2,98 +2,78 @@
 #include "fileutils.h"
 #include "locutil.h"
 #include "decompressor.h"
+#include "chunk.h"
+#include "RegionIndex.h"
+#include "BitUnpack.h"
 #include <vector>
+#include <string>
+#include <fstream>
 #include <iostream>
 
 using namespace std;
 
 /**
- * @brief 计算区块在区域文件中的偏移量
+ * @brief 读取外部 c.X.Z.mcc 文件(超过 1MB 的区块)
  * 
- * @param fileData 区域文件数据
- * @param x 区块X坐标(相对区域)
- * @param z 区块Z坐标(相对区域)
- * @return unsigned 区块在文件中的偏移量字节位置，失败返回0
+ * @param x 区块X坐标(全局)
+ * @param z 区块Z坐标(全局)
+ * @param data 输出文件内容(复用调用方缓冲区)
+ * @return bool 读取成功返回 true
  */
-unsigned CalculateChunkOffset(const std::vector<char>& fileData, int x, int z) {
-    // 计算索引位置(每个索引占4字节)
-    unsigned index = 4 * (x + z * 32);
-    
-    // 检查是否越界
-    if (index + 3 >= fileData.size()) {
-        cerr << "错误: 无效的索引或文件大小." << endl;
-        return 0; // 返回0表示计算失败
+static bool ReadExternalChunk(int x, int z, std::vector<char>& data) {
+    std::string filePath = RegionIndex::GetRegionDirectory() + "/c." + std::to_string(x) + "." + std::to_string(z) + ".mcc";
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file) {
+        cerr << "错误: 无法打开外部区块文件: " << filePath << endl;
+        return false;
     }
-    
-    // 读取前3个字节计算偏移量(大端字节序)
-    unsigned char byte1 = fileData[index];
-    unsigned char byte2 = fileData[index + 1];
-    unsigned char byte3 = fileData[index + 2];
-    
-    // 将3字节转换为偏移量(单位:4KB扇区)
-    return (byte1 * 256 * 256 + byte2 * 256 + byte3) * 4096;
-}
-
-/**
- * @brief 提取区块数据的长度
- * 
- * @param fileData 区域文件数据
- * @param offset 区块数据起始偏移量
- * @return unsigned 区块数据长度(字节)
- */
-unsigned ExtractChunkLength(const std::vector<char>& fileData, unsigned offset) {
-    // 读取4字节长度值(大端字节序)
-    unsigned byte1 = (unsigned char)fileData[offset];
-    unsigned byte2 = (unsigned char)fileData[offset + 1];
-    unsigned byte3 = (unsigned char)fileData[offset + 2];
-    unsigned byte4 = (unsigned char)fileData[offset + 3];
-    
-    // 合并4字节为长度值
-    return (byte1 << 24) | (byte2 << 16) | (byte3 << 8) | byte4;
+    std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    data.resize(static_cast<size_t>(size));
+    return size > 0 && file.read(data.data(), size).good();
 }
 
 /**
  * @brief 获取区块的NBT数据
  * 
  * 该函数从区域文件中提取特定区块的NBT数据，过程包括:
- * 1. 计算区块在文件中的偏移位置
- * 2. 提取区块数据长度
- * 3. 提取并解压区块数据
+ * 1. 通过偏移表定位区块在映射文件中的位置
+ * 2. 按区块头中的压缩类型直接在映射内存上解压(不复制压缩负载)
+ * 3. 压缩类型带 0x80 标志时改为读取外部 c.X.Z.mcc 文件
  * 
- * @param fileData 区域文件的原始二进制数据
+ * @param region 已映射的区域文件
  * @param x 区块X坐标(全局)
  * @param z 区块Z坐标(全局)
- * @return std::vector<char> 解压后的区块NBT数据，失败返回空vector
+ * @param nbtData 输出解压后的区块NBT数据(容量会被保留以便复用)
+ * @return bool 成功返回 true
  */
-std::vector<char> GetChunkNBTData(const std::vector<char>& fileData, int x, int z) {
-    // 第1步: 计算区块在区域文件中的偏移量
+bool GetChunkNBTData(const RegionFile& region, int x, int z, ByteBuffer& nbtData) {
+    // 第1步: 定位区块负载
     int localX = mod32(x);  // 转换为区域内相对坐标(0-31)
     int localZ = mod32(z);
-    unsigned offset = CalculateChunkOffset(fileData, localX, localZ);
-    
-    if (offset == 0) {
+    uint8_t compressionType = 0;
+    std::span<const char> chunkData = region.GetChunkPayload(localX, localZ, compressionType);
+
+    if (compressionType == 0) {
         cerr << "错误: 偏移计算失败." << endl;
-        return {};
+        return false;
     }
 
-    // 第2步: 提取区块数据长度
-    unsigned length = ExtractChunkLength(fileData, offset);
-    
-    // 根据 length 和 offset 检查整个区块数据是否在文件范围内
-    uint64_t endOffset = static_cast<uint64_t>(offset) + 4 + length;
-    if (endOffset > fileData.size()) {
-        cerr << "错误: 区块数据超出了文件边界." << endl;
-        return {};
+    // 第2步: 外部区块文件
+    if (compressionType & kExternalChunkFlag) {
+        thread_local std::vector<char> externalData;
+        if (!ReadExternalChunk(x, z, externalData)) {
+            return false;
+        }
+        chunkData = externalData;
     }
-    unsigned startOffset = offset + 5; // 跳过4字节长度+1字节压缩类型
-    vector<char> chunkData(fileData.begin() + startOffset, fileData.begin() + endOffset);
-    vector<char> decompressedData;
-    if (DecompressData(chunkData, decompressedData)) {
-        return decompressedData;
-    } else {
+
+    // 第3步: 解压区块数据
+    if (!DecompressChunk(chunkData, compressionType, nbtData)) {
         cerr << "错误: 解压失败." << endl;
-        return {};
+        return false;
     }
+    return true;
 }
 
 /**
@@ -102,31 +82,14 @@ std::vector<char> GetChunkNBTData(const std::vector<char>& fileData, int x, int
  * 该函数从压缩的高度图数据中提取256个高度值
  * 支持8位和9位格式的高度图数据
  * 
- * @param data 高度图原始数据(通常是37个int64值)
+ * @param data 高度图原始大端字节(通常是37个long)
  * @return std::vector<int> 256个高度值构成的数组
  */
-std::vector<int> DecodeHeightMap(const std::vector<int64_t>& data) {
-    // 预分配256个高度值,避免多次重分配
-    std::vector<int> heights;
-    heights.reserve(256);
-    
+std::vector<int> DecodeHeightMap(std::span<const char> data) {
+    std::vector<int> heights(256, 0);
+
     // 根据数据长度动态判断存储格式(37个long为9位格式,否则为8位)
-    int bitsPerEntry = (data.size() == 37) ? 9 : 8;
-    int entriesPerLong = 64 / bitsPerEntry;  // 每个long值可存储的条目数
-    int mask = (1 << bitsPerEntry) - 1;      // 创建位掩码(例如8位为0xFF, 9位为0x1FF)
-    
-    // 从每个long值中提取多个高度值
-    for (const auto& longVal : data) {
-        int64_t value = reverseEndian(longVal);  // 处理字节序
-        for (int i = 0; i < entriesPerLong; ++i) {
-            // 提取指定位置的bits
-            heights.push_back(static_cast<int>((value >> (i * bitsPerEntry)) & mask));
-            if (heights.size() >= 256) break;  // 达到256个高度值后停止
-        }
-        if (heights.size() >= 256) break;      // 确保不超过256个值
-    }
-    
-    // 确保返回恰好256个高度值
-    heights.resize(256);
+    int bitsPerEntry = (data.size() / sizeof(int64_t) == 37) ? 9 : 8;
+    BitUnpack::Unpack(data, bitsPerEntry, heights.size(), heights.data());
     return heights;
 }
@@ -8,23 +8,30 @@
  */
 #pragma once
 #include <vector>
+#include <cstdint>
+#include <span>
+#include "RegionFile.h"
+#include "decompressor.h"
 
 /**
  * @brief 从区域文件数据中读取特定区块的NBT数据
  * 
- * @param fileData 区域文件的完整二进制数据
+ * 支持 gzip/zlib/不压缩/LZ4 以及外部 .mcc 区块
+ * 
+ * @param region 已映射的区域文件
  * @param x 区块的X坐标(全局坐标)
  * @param z 区块的Z坐标(全局坐标)
- * @return std::vector<char> 解压后的区块NBT数据，如果提取失败则返回空vector
+ * @param nbtData 输出解压后的区块NBT数据，调用方可在多个区块间复用该缓冲区
+ * @return bool 提取成功返回 true
  */
-std::vector<char> GetChunkNBTData(const std::vector<char>& fileData, int x, int z);
+bool GetChunkNBTData(const RegionFile& region, int x, int z, ByteBuffer& nbtData);
 
 /**
  * @brief 解析区块的高度图数据
  * 
  * 高度图数据表示区块中每个列(x,z位置)的最高非空气方块的y坐标
  * 
- * @param data 从NBT数据中提取的原始高度图数据(通常是一组Long值)
+ * @param data 高度图 LONG_ARRAY 的原始大端字节
  * @return std::vector<int> 由256个高度值组成的数组，对应区块内16x16个列
  */
-std::vector<int> DecodeHeightMap(const std::vector<int64_t>& data);
\ No newline at end of file
+std::vector<int> DecodeHeightMap(std::span<const char> data);
\ No newline at end of file
@@ -6,6 +6,9 @@
 #include <iostream>
 #include <algorithm>
 #include "include/json.hpp"
+
+Config config;  // 定义全局变量
+
 Config LoadConfig(const std::string& configFile) {
     Config config;
     std::cout << "[DEBUG] Attempting to load config file: " << configFile << std::endl;
@@ -99,6 +102,11 @@ Config LoadConfig(const std::string& configFile) {
     // 读取每批次的区块任务数量上限（如果存在）
     config.maxTasksPerBatch = j.value("maxTasksPerBatch", config.maxTasksPerBatch);
 
+    // 区域文件缓存的内存预算(MB)
+    config.regionCacheBudgetMB = j.value("regionCacheBudgetMB", config.regionCacheBudgetMB);
+    // 后台预读的字节上限(MB)
+    config.prefetchBudgetMB = j.value("prefetchBudgetMB", config.prefetchBudgetMB);
+
 
     config.selectedDimension = j.value("selectedDimension", config.selectedDimension);
 
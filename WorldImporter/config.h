@@ -64,6 +64,8 @@ struct Config {
     bool exportFullModel;  // 是否完整导入
     int partitionSize; //分割大小
     size_t maxTasksPerBatch; //每批次区块任务数量上限
+    size_t regionCacheBudgetMB; //区域文件缓存的内存预算(MB),超出后按LRU淘汰
+    size_t prefetchBudgetMB; //后台预读下一批次区域数据的字节上限(MB),0为关闭预读
 
     int decimalPlaces; //lod群系颜色值小数精度 #待做
     bool importByBlockType;  // 是否按方块种类导入 #待做
@@ -109,6 +111,8 @@ struct Config {
         exportFullModel(false),
         partitionSize(4),
         maxTasksPerBatch(32768),
+        regionCacheBudgetMB(2048),
+        prefetchBudgetMB(512),
 
         decimalPlaces(2),
         importByBlockType(false),
@@ -1,35 +1,230 @@
 ﻿#include <zlib.h>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
 #include "decompressor.h"
 
-// 解压区块数据
-bool DecompressData(const std::vector<char>& chunkData, std::vector<char>& decompressedData) {
-    // 输出压缩数据的大小
-    uLongf decompressedSize = chunkData.size() * 10;  // 假设解压后的数据大小为压缩数据的 10 倍
-    decompressedData.resize(decompressedSize);
-
-    // 调用解压函数
-    int result = uncompress(reinterpret_cast<Bytef*>(decompressedData.data()), &decompressedSize,
-        reinterpret_cast<const Bytef*>(chunkData.data()), chunkData.size());
-
-    // 如果输出缓冲区太小,则动态扩展缓冲区
-    while (result == Z_BUF_ERROR) {
-        decompressedSize *= 2;  // 增加缓冲区大小
-        decompressedData.resize(decompressedSize);
-        result = uncompress(reinterpret_cast<Bytef*>(decompressedData.data()), &decompressedSize,
-            reinterpret_cast<const Bytef*>(chunkData.data()), chunkData.size());
+namespace {
 
-    }
+    // 每个线程一个 z_stream,通过 inflateReset2 复用内部窗口与状态
+    struct ThreadInflater {
+        z_stream stream{};
+        int windowBits = 0;
+        bool initialized = false;
+
+        ~ThreadInflater() {
+            if (initialized) {
+                inflateEnd(&stream);
+            }
+        }
+
+        bool Reset(int bits) {
+            if (!initialized) {
+                stream.zalloc = Z_NULL;
+                stream.zfree = Z_NULL;
+                stream.opaque = Z_NULL;
+                if (inflateInit2(&stream, bits) != Z_OK) {
+                    return false;
+                }
+                initialized = true;
+                windowBits = bits;
+                return true;
+            }
+            if (bits != windowBits) {
+                windowBits = bits;
+                return inflateReset2(&stream, bits) == Z_OK;
+            }
+            return inflateReset(&stream) == Z_OK;
+        }
+    };
+
+    thread_local ThreadInflater inflater;
+
+    // 流式解压,输出缓冲区不足时扩容后继续解压
+    bool Inflate(std::span<const char> input, int windowBits, ByteBuffer& output) {
+        if (!inflater.Reset(windowBits)) {
+            std::cerr << "错误: 初始化解压流失败" << std::endl;
+            return false;
+        }
+
+        // 初始容量:已有容量与 4 倍压缩大小取较大值;旧内容不需要保留,先清空避免扩容时复制
+        size_t capacity = std::max<size_t>(output.capacity(), std::max<size_t>(input.size() * 4, 64 * 1024));
+        output.clear();
+        output.resize(capacity);
+
+        z_stream& strm = inflater.stream;
+        strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        strm.avail_in = static_cast<uInt>(input.size());
+        strm.next_out = reinterpret_cast<Bytef*>(output.data());
+        strm.avail_out = static_cast<uInt>(output.size());
 
-    // 根据解压结果提供不同的日志信息
-    if (result == Z_OK) {
-        decompressedData.resize(decompressedSize);  // 修正解压数据的实际大小
+        int result = Z_OK;
+        while (true) {
+            result = inflate(&strm, Z_NO_FLUSH);
+            if (result == Z_STREAM_END) {
+                break;
+            }
+            if (result == Z_BUF_ERROR && strm.avail_out != 0) {
+                // 输入已耗尽但流未结束:数据被截断
+                break;
+            }
+            if (result != Z_OK && result != Z_BUF_ERROR) {
+                break;
+            }
+            if (strm.avail_out == 0) {
+                size_t produced = output.size();
+                output.resize(produced * 2);
+                strm.next_out = reinterpret_cast<Bytef*>(output.data() + produced);
+                strm.avail_out = static_cast<uInt>(output.size() - produced);
+            }
+        }
+
+        if (result != Z_STREAM_END) {
+            std::cerr << "错误: 解压失败,错误代码: " << result << std::endl;
+            output.clear();
+            return false;
+        }
+        output.resize(strm.total_out);
         return true;
     }
-    else {
-        std::cerr <<"错误: 解压失败,错误代码: " << result << std::endl;
 
-        return false;
+    inline uint32_t ReadLE32(const unsigned char* p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    // 解码一个 LZ4 原始块,dst 必须恰好为解压后大小
+    bool DecodeLZ4Block(const unsigned char* src, size_t srcSize, char* dst, size_t dstSize) {
+        const unsigned char* ip = src;
+        const unsigned char* const iend = src + srcSize;
+        char* op = dst;
+        char* const oend = dst + dstSize;
+
+        while (ip < iend) {
+            unsigned token = *ip++;
+
+            // 字面量长度
+            size_t literalLength = token >> 4;
+            if (literalLength == 15) {
+                unsigned char s;
+                do {
+                    if (ip >= iend) return false;
+                    s = *ip++;
+                    literalLength += s;
+                } while (s == 255);
+            }
+            if (literalLength > static_cast<size_t>(iend - ip) || literalLength > static_cast<size_t>(oend - op)) {
+                return false;
+            }
+            std::memcpy(op, ip, literalLength);
+            ip += literalLength;
+            op += literalLength;
+
+            // 最后一个序列只有字面量
+            if (ip >= iend) break;
+
+            if (iend - ip < 2) return false;
+            size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+            ip += 2;
+            if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+
+            size_t matchLength = token & 0x0F;
+            if (matchLength == 15) {
+                unsigned char s;
+                do {
+                    if (ip >= iend) return false;
+                    s = *ip++;
+                    matchLength += s;
+                } while (s == 255);
+            }
+            matchLength += 4;
+            if (matchLength > static_cast<size_t>(oend - op)) return false;
+
+            const char* match = op - offset;
+            if (offset >= matchLength) {
+                std::memcpy(op, match, matchLength);
+                op += matchLength;
+            } else {
+                // 重叠复制需逐字节进行
+                for (size_t i = 0; i < matchLength; ++i) {
+                    *op++ = *match++;
+                }
+            }
+        }
+        return op == oend;
+    }
+
+    // 解压 lz4-java LZ4BlockOutputStream 格式:
+    // "LZ4Block" + token(1) + 压缩长度(4,LE) + 原始长度(4,LE) + 校验(4,LE) + 数据,直至长度为0的结束块
+    bool DecompressLZ4Stream(std::span<const char> input, ByteBuffer& output) {
+        static constexpr char kMagic[8] = { 'L', 'Z', '4', 'B', 'l', 'o', 'c', 'k' };
+        static constexpr size_t kBlockHeaderSize = 8 + 1 + 4 + 4 + 4;
+        static constexpr unsigned kMethodRaw = 0x10;
+        static constexpr unsigned kMethodLZ4 = 0x20;
+
+        output.clear();
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(input.data());
+        size_t remaining = input.size();
+
+        while (remaining >= kBlockHeaderSize) {
+            if (std::memcmp(p, kMagic, sizeof(kMagic)) != 0) {
+                std::cerr << "错误: LZ4 块标识无效" << std::endl;
+                return false;
+            }
+            unsigned method = p[8] & 0xF0;
+            uint32_t compressedLength = ReadLE32(p + 9);
+            uint32_t originalLength = ReadLE32(p + 13);
+            p += kBlockHeaderSize;
+            remaining -= kBlockHeaderSize;
+
+            // 结束块
+            if (originalLength == 0 && compressedLength == 0) {
+                return true;
+            }
+            if (compressedLength > remaining) {
+                std::cerr << "错误: LZ4 块数据被截断" << std::endl;
+                return false;
+            }
+
+            size_t produced = output.size();
+            output.resize(produced + originalLength);
+            if (method == kMethodRaw) {
+                if (compressedLength != originalLength) return false;
+                std::memcpy(output.data() + produced, p, originalLength);
+            } else if (method == kMethodLZ4) {
+                if (!DecodeLZ4Block(p, compressedLength, output.data() + produced, originalLength)) {
+                    std::cerr << "错误: LZ4 块解码失败" << std::endl;
+                    return false;
+                }
+            } else {
+                std::cerr << "错误: 未知的 LZ4 压缩方法: " << method << std::endl;
+                return false;
+            }
+            p += compressedLength;
+            remaining -= compressedLength;
+        }
+        // 部分写入端不写结束块,数据恰好用尽时也视为成功
+        return remaining == 0 && !output.empty();
     }
 }
 
+// 解压区块数据
+bool DecompressData(std::span<const char> chunkData, ByteBuffer& decompressedData) {
+    return Inflate(chunkData, MAX_WBITS, decompressedData);
+}
+
+bool DecompressChunk(std::span<const char> chunkData, uint8_t compressionType, ByteBuffer& decompressedData) {
+    switch (static_cast<ChunkCompression>(compressionType & ~kExternalChunkFlag)) {
+    case ChunkCompression::GZip:
+        return Inflate(chunkData, MAX_WBITS + 16, decompressedData);
+    case ChunkCompression::Zlib:
+        return Inflate(chunkData, MAX_WBITS, decompressedData);
+    case ChunkCompression::None:
+        decompressedData.assign(chunkData.begin(), chunkData.end());
+        return true;
+    case ChunkCompression::LZ4:
+        return DecompressLZ4Stream(chunkData, decompressedData);
+    default:
+        std::cerr << "错误: 未知的区块压缩类型: " << static_cast<int>(compressionType) << std::endl;
+        return false;
+    }
+}
@@ -3,8 +3,53 @@
 
 #include <vector>
 #include <string> 
+#include <span>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// 区块压缩类型(区块头第5字节)
+enum class ChunkCompression : uint8_t {
+    GZip = 1,
+    Zlib = 2,
+    None = 3,
+    LZ4 = 4,
+};
+
+// 置位时表示区块数据存放在外部 c.X.Z.mcc 文件中
+constexpr uint8_t kExternalChunkFlag = 0x80;
+
+// 不对新元素做值初始化的分配器:resize 扩容时不清零,由解压直接覆盖
+template <typename T>
+struct DefaultInitAllocator : std::allocator<T> {
+    template <typename U>
+    struct rebind { using other = DefaultInitAllocator<U>; };
+
+    DefaultInitAllocator() noexcept = default;
+    template <typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+// 解压输出缓冲区,跨区块复用时扩容不会清零整个缓冲区
+using ByteBuffer = std::vector<char, DefaultInitAllocator<char>>;
 
 //zlib解压方法
-bool DecompressData(const std::vector<char>& chunkData, std::vector<char>& decompressedData);
+bool DecompressData(std::span<const char> chunkData, ByteBuffer& decompressedData);
+
+// 按压缩类型解压区块负载(gzip/zlib/不压缩/LZ4)
+// 每个线程复用同一个 z_stream,输出写入 decompressedData 并按需扩容,不会重新开始解压
+// decompressedData 的容量会被保留,调用方可跨区块复用同一个缓冲区
+bool DecompressChunk(std::span<const char> chunkData, uint8_t compressionType, ByteBuffer& decompressedData);
 
 #endif // DECOMPRESSOR_H
@@ -2,19 +2,51 @@
 #include <cmath>
 #include <algorithm>
 #include <iostream>
-#include <sstream>
 #include "block.h"
+#include "BlockTraits.h"
+#include "MaterialRegistry.h"
 #include <unordered_map>
-#include <mutex>
 #include "model.h"
 
 using namespace std;
 
 // 流体注册数据
 std::unordered_map<std::string, FluidInfo> fluidDefinitions;
-// 模型缓存
-static std::unordered_map<int, ModelData> fluidModelCache;
-static std::mutex fluidModelCacheMutex; 
+// 流体模型缓存
+FluidModelCache fluidModels;
+
+namespace {
+    // 液位按 5 位打包(-2..29),流体编号占 13 位,最高位标记非空键
+    constexpr int kLevelBits = 5;
+    constexpr int kFluidBits = 13;
+    constexpr uint64_t kNoFluidCode = (uint64_t(1) << kFluidBits) - 1;
+
+    // 打包后的键低位分布不均,取槽位前先混合
+    size_t MixKey(uint64_t key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return static_cast<size_t>(key);
+    }
+}
+
+uint64_t FluidModelCache::PackKey(const std::array<int, 10>& fluidLevels, uint16_t fluidId) {
+    uint64_t key = 0;
+    for (int level : fluidLevels) {
+        const int biased = level + 2;
+        if (biased < 0 || biased >= (1 << kLevelBits)) return 0;
+        key = (key << kLevelBits) | static_cast<uint64_t>(biased);
+    }
+    uint64_t fluidCode = kNoFluidCode;
+    if (fluidId != BlockTraitsTable::kNoFluid) {
+        if (fluidId >= kNoFluidCode) return 0;
+        fluidCode = fluidId;
+    }
+    key = (key << kFluidBits) | fluidCode;
+    return key | (uint64_t(1) << 63);
+}
 
 float getHeight(int level) {
     if (level == 0)
@@ -99,7 +131,8 @@ float getCornerHeight(float currentHeight, float NWHeight, float NHeight, float
     return (totalWeight == 0.0f) ? 0.0f : res / totalWeight;
 }
 
-ModelData GenerateFluidModel(const std::array<int, 10>& fluidLevels, const std::string& fluidId) {
+// 按液位生成流体方块的几何,UV 按 materials([still, flow])的长宽比计算
+static ModelData BuildFluidGeometry(const std::array<int, 10>& fluidLevels, const std::vector<Material>& materials) {
     ModelData model;
 
     // 获取当前方块的液位和周围液位的高度
@@ -114,21 +147,6 @@ ModelData GenerateFluidModel(const std::array<int, 10>& fluidLevels, const std::
     int southwestLevel = fluidLevels[8]; // 西南
     int aboveLevel = fluidLevels[9];     // 上方
 
-    size_t key = 0;
-    for (int level : fluidLevels) {
-        key = (key << 3) ^ (level + (level << 5));
-    }
-    // 结合流体ID，确保不同流体类型有不同的缓存键值
-    key = key ^ std::hash<std::string>{}(fluidId);
-
-    // Lock the mutex to safely access the cache
-    std::lock_guard<std::mutex> lock(fluidModelCacheMutex);
-
-    // 检查缓存中是否存在该模型
-    if (fluidModelCache.find(key) != fluidModelCache.end()) {
-        return fluidModelCache[key]; // 返回缓存中的模型
-    }
-
     float currentHeight = getHeight(currentLevel);
     float northHeight = getHeight(northLevel);
     float southHeight = getHeight(southLevel);
@@ -227,40 +245,9 @@ ModelData GenerateFluidModel(const std::array<int, 10>& fluidLevels, const std::
     model.faces[5].faceDirection = EAST;
     model.faces[5].materialIndex = 1; // flow材质
 
-    // 提取流体ID的命名空间和基础名
-    std::string namespace_name = "minecraft";
-    std::string base_id = fluidId;
-    
-    size_t colonPos = fluidId.find(':');
-    if (colonPos != std::string::npos) {
-        namespace_name = fluidId.substr(0, colonPos);
-        base_id = fluidId.substr(colonPos + 1);
-    }
-    
-    size_t bracketPos = base_id.find('[');
-    if (bracketPos != std::string::npos) {
-        base_id = base_id.substr(0, bracketPos);
-    }
-    
-    // 寻找流体定义
-    std::string stillTexturePath = "block/" + base_id + "_still";
-    std::string flowTexturePath = "block/" + base_id + "_flow";
-    
-    // 如果有对应的流体定义，使用其中的路径
-    auto fluidIt = fluidDefinitions.find(namespace_name + ":" + base_id);
-    if (fluidIt != fluidDefinitions.end()) {
-        const FluidInfo& info = fluidIt->second;
-        stillTexturePath = info.folder + "/" + base_id + info.still_texture;
-        flowTexturePath = info.folder + "/" + base_id + info.flow_texture;
-    }
-    
     // 获取流体纹理的长宽比
-    float stillAspectRatio = 1.0f;
-    float flowAspectRatio = 1.0f;
-
-    // 获取材质的长宽比
-    MaterialType stillType = DetectMaterialType(namespace_name, stillTexturePath, stillAspectRatio);
-    MaterialType flowType = DetectMaterialType(namespace_name, flowTexturePath, flowAspectRatio);
+    float stillAspectRatio = materials[0].aspectRatio;
+    float flowAspectRatio = materials[1].aspectRatio;
 
     // 确保长宽比至少为1，避免除以0的错误
     if (stillAspectRatio < 1.0f) {
@@ -397,125 +384,126 @@ ModelData GenerateFluidModel(const std::array<int, 10>& fluidLevels, const std::
         }
     }
 
-    // 添加材质
+    model.materials = materials;
+    return model;
+}
+
+// 生成流体的 still/flow 材质
+// 有流体定义时使用定义中的纹理目录与后缀,否则使用 block/<名称>_still、block/<名称>_flow
+static std::vector<Material> BuildFluidMaterials(const std::string& fluidName) {
+    size_t colonPos = fluidName.find(':');
+    std::string ns = (colonPos != std::string::npos) ? fluidName.substr(0, colonPos) : "minecraft";
+    std::string pureName = (colonPos != std::string::npos) ? fluidName.substr(colonPos + 1) : fluidName;
+
+    std::string stillTexture = "block/" + pureName + "_still";
+    std::string flowTexture = "block/" + pureName + "_flow";
+    std::string stillName = pureName + "_still";
+    std::string flowName = pureName + "_flow";
+    auto fluidIt = fluidDefinitions.find(fluidName);
+    if (fluidIt != fluidDefinitions.end()) {
+        const FluidInfo& fluidInfo = fluidIt->second;
+        stillTexture = fluidInfo.folder + "/" + pureName + fluidInfo.still_texture;
+        flowTexture = fluidInfo.folder + "/" + pureName + fluidInfo.flow_texture;
+        stillName = stillTexture;
+        flowName = flowTexture;
+    }
+    const int8_t tintIndex = (pureName.find("water") != std::string::npos) ? 2 : -1; // 只对水使用色调索引2
+
     // 静止流体材质(still)- 用于顶部和底部
-    Material stillMaterial;
-    stillMaterial.name = base_id + "_still";
-    stillMaterial.texturePath = "textures/" + namespace_name + "/" + stillTexturePath + ".png";
-    stillMaterial.tintIndex = (base_id.find("water") != string::npos) ? 2 : -1; // 只对水使用色调索引2
-    stillMaterial.type = stillType;
-    stillMaterial.aspectRatio = stillAspectRatio; // 设置材质长宽比
+    Material stillFluid;
+    stillFluid.name = stillName;
+    stillFluid.texturePath = "textures/" + ns + "/" + stillTexture + ".png";
+    stillFluid.tintIndex = tintIndex;
+    stillFluid.type = DetectMaterialType(ns, stillTexture, stillFluid.aspectRatio);
 
     // 流动流体材质(flow)- 用于侧面
-    Material flowMaterial;
-    flowMaterial.name = base_id + "_flow"; 
-    flowMaterial.texturePath = "textures/" + namespace_name + "/" + flowTexturePath + ".png";
-    flowMaterial.tintIndex = (base_id.find("water") != string::npos) ? 2 : -1; // 只对水使用色调索引2
-    flowMaterial.type = flowType;
-    flowMaterial.aspectRatio = flowAspectRatio; // 设置材质长宽比
+    Material flowFluid;
+    flowFluid.name = flowName;
+    flowFluid.texturePath = "textures/" + ns + "/" + flowTexture + ".png";
+    flowFluid.tintIndex = tintIndex;
+    flowFluid.type = DetectMaterialType(ns, flowTexture, flowFluid.aspectRatio);
 
-    model.materials = { stillMaterial, flowMaterial };
+    return { stillFluid, flowFluid };
+}
 
-    fluidModelCache[key] = model;
-    return model;
+FluidModelCache::FluidModelCache()
+    : m_slots(new Slot[kCapacity]),
+      m_materialSets(new std::atomic<const MaterialSet*>[kMaxFluidIds]()) {
 }
 
-void AssignFluidMaterials(ModelData& model, const std::string& fluidId) {
-    if (fluidId.find("minecraft:water") != string::npos) {
-        // 为所有材质设置水的着色索引
-        for (auto& material : model.materials) {
-            material.tintIndex = 2;
-        }
+FluidModelCache::~FluidModelCache() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+        delete m_slots[i].model.load(std::memory_order_relaxed);
     }
-    else
-    {
-        // 为所有材质设置无着色
-        for (auto& material : model.materials) {
-            material.tintIndex = -1;
-        }
+    for (size_t i = 0; i < kMaxFluidIds; ++i) {
+        delete m_materialSets[i].load(std::memory_order_relaxed);
     }
-    // 提取基础 ID 和状态值(如果有多个状态值)
-    std::string baseId;
-    std::unordered_map<std::string, std::string> stateValues;
+}
 
-    size_t bracketPos = fluidId.find('[');
-    if (bracketPos != std::string::npos) {
-        baseId = fluidId.substr(0, bracketPos);
+const FluidModelCache::MaterialSet& FluidModelCache::GetMaterialSet(uint16_t fluidId) {
+    std::atomic<const MaterialSet*>& slot = m_materialSets[fluidId];
+    const MaterialSet* set = slot.load(std::memory_order_acquire);
+    if (set) {
+        return *set;
+    }
 
-        std::string statePart = fluidId.substr(bracketPos + 1, fluidId.size() - bracketPos - 2); // Remove the closing ']'
-        std::stringstream ss(statePart);
-        std::string statePair;
+    // 多个线程同时生成同一流体的材质时只保留先完成的结果
+    const std::string& fluidName = (fluidId == BlockTraitsTable::kNoFluid) ? std::string("minecraft:water") : blockTraits.FluidName(fluidId);
+    auto built = std::make_unique<MaterialSet>();
+    built->materials = BuildFluidMaterials(fluidName);
+    materialRegistry.InternAll(built->materials, built->materialIds);
+    const MaterialSet* expected = nullptr;
+    if (slot.compare_exchange_strong(expected, built.get(), std::memory_order_acq_rel)) {
+        return *built.release();
+    }
+    return *expected;
+}
 
-        while (std::getline(ss, statePair, ',')) {
-            size_t equalPos = statePair.find(':');
-            if (equalPos != std::string::npos) {
-                std::string key = statePair.substr(0, equalPos);
-                std::string value = statePair.substr(equalPos + 1);
+const std::vector<Material>& FluidModelCache::Materials(uint16_t fluidId) {
+    return GetMaterialSet(fluidId).materials;
+}
 
-                stateValues[key] = value;
-            }
-        }
-    }
-    else {
-        baseId = fluidId;
-    }
+FluidModel FluidModelCache::Build(const std::array<int, 10>& fluidLevels, uint16_t fluidId) {
+    const MaterialSet& set = GetMaterialSet(fluidId);
+    FluidModel result;
+    result.model = BuildFluidGeometry(fluidLevels, set.materials);
+    result.materialIds = set.materialIds;
+    return result;
+}
 
-    // 尝试查找流体定义
-    auto fluidIt = fluidDefinitions.find(baseId);
-    if (fluidIt == fluidDefinitions.end()) {
-        // 尝试匹配 level_property
-        for (const auto& entry : fluidDefinitions) {
-            if (stateValues.count(entry.second.property) > 0) {
-                fluidIt = fluidDefinitions.find(entry.first);
-                break;
+const FluidModel& FluidModelCache::Get(const std::array<int, 10>& fluidLevels, uint16_t fluidId) {
+    const uint64_t key = PackKey(fluidLevels, fluidId);
+    if (key != 0) {
+        size_t index = MixKey(key) & (kCapacity - 1);
+        for (size_t probe = 0; probe < kMaxProbe; ++probe, index = (index + 1) & (kCapacity - 1)) {
+            Slot& slot = m_slots[index];
+            uint64_t slotKey = slot.key.load(std::memory_order_acquire);
+            if (slotKey == 0 && slot.key.compare_exchange_strong(slotKey, key, std::memory_order_acq_rel)) {
+                slotKey = key; // 占用了空槽
             }
-        }
-
-        if (fluidIt == fluidDefinitions.end()) {
-            // 尝试匹配 liquid_blocks
-            for (const auto& entry : fluidDefinitions) {
-                if (entry.second.liquid_blocks.count(baseId) > 0) {
-                    fluidIt = fluidDefinitions.find(entry.first);
-                    break;
-                }
+            if (slotKey != key) {
+                continue;
             }
-        }
 
-        if (fluidIt == fluidDefinitions.end()) {
-            // 如果仍然没找到,直接返回
-            return;
+            const FluidModel* model = slot.model.load(std::memory_order_acquire);
+            if (model) {
+                return *model;
+            }
+            // 键已登记但模型尚未发布时各自生成,只保留先发布的结果
+            auto built = std::make_unique<FluidModel>(Build(fluidLevels, fluidId));
+            const FluidModel* expected = nullptr;
+            if (slot.model.compare_exchange_strong(expected, built.get(), std::memory_order_acq_rel)) {
+                return *built.release();
+            }
+            return *expected;
         }
     }
 
-    const FluidInfo& fluidInfo = fluidIt->second;
-    std::string fluidName = fluidIt->first;
-    // 清空旧数据
-    model.materials.clear();
-
-    // 使用fluidName解析命名空间和纯名称
-    size_t colonPosDef = fluidName.find(':');
-    std::string ns = (colonPosDef != std::string::npos) ? fluidName.substr(0, colonPosDef) : "";
-    std::string pureName = (colonPosDef != std::string::npos) ? fluidName.substr(colonPosDef + 1) : fluidName;
-    
-    // 获取材质长宽比
-    float stillAspectRatio = 1.0f;
-    float flowAspectRatio = 1.0f;
-    
-    // 创建静止流体材质
-    Material stillFluid;
-    stillFluid.name = fluidInfo.folder + "/" + pureName + fluidInfo.still_texture;
-    stillFluid.texturePath = "textures/" + ns + "/" + fluidInfo.folder + "/" + pureName + fluidInfo.still_texture + ".png";
-    stillFluid.tintIndex = (pureName.find("water") != std::string::npos) ? 2 : -1;
-    stillFluid.type = DetectMaterialType(ns, fluidInfo.folder + "/" + pureName + fluidInfo.still_texture, stillAspectRatio);
-    stillFluid.aspectRatio = stillAspectRatio;
-    
-    // 创建流动流体材质
-    Material flowFluid;
-    flowFluid.name = fluidInfo.folder + "/" + pureName + fluidInfo.flow_texture;
-    flowFluid.texturePath = "textures/" + ns + "/" + fluidInfo.folder + "/" + pureName + fluidInfo.flow_texture + ".png";
-    flowFluid.tintIndex = (pureName.find("water") != std::string::npos) ? 2 : -1;
-    flowFluid.type = DetectMaterialType(ns, fluidInfo.folder + "/" + pureName + fluidInfo.flow_texture, flowAspectRatio);
-    flowFluid.aspectRatio = flowAspectRatio;
-    
-    model.materials = { stillFluid, flowFluid };
-}
\ No newline at end of file
+    // 无法打包或探测过长(表接近满)时使用加锁的精确表
+    std::lock_guard<std::mutex> lock(m_overflowMutex);
+    std::unique_ptr<FluidModel>& model = m_overflow[{ fluidLevels, fluidId }];
+    if (!model) {
+        model = std::make_unique<FluidModel>(Build(fluidLevels, fluidId));
+    }
+    return *model;
+}
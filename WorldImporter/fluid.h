@@ -6,6 +6,11 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include "model.h"
 
 // 流体定义信息结构
@@ -27,10 +32,60 @@ float getHeight(int level);
 // 计算角落高度的函数
 float getCornerHeight(float currentHeight, float NWHeight, float NHeight, float WHeight);
 
-// 使用fluidId和周围的液位生成流体模型
-ModelData GenerateFluidModel(const std::array<int, 10>& fluidLevels, const std::string& fluidId = "minecraft:water");
+// 一个流体方块的模型(局部坐标),materials 为 [still, flow]
+// faces 顺序固定为 下、上、北、南、西、东
+struct FluidModel {
+    ModelData model;
+    std::vector<uint32_t> materialIds; // materials 对应的 materialRegistry ID
+};
+
+// 流体模型缓存
+// 键为打包后的完整邻域描述:10 个液位(自身、8 个水平邻居与上方,决定四角高度、流向与顶面是否剔除)加流体编号,
+// 键相等即模型相同,不会因哈希冲突返回错误的模型。查找为无锁的开放寻址表,模型生成后不再修改,
+// 返回的引用在程序运行期间一直有效。液位超出打包范围或探测过长时退回加锁的精确表。
+class FluidModelCache {
+public:
+    FluidModelCache();
+    ~FluidModelCache();
+
+    // fluidLevels 顺序与 GetBlockIdWithNeighbors 一致;fluidId 为 blockTraits.FluidId
+    const FluidModel& Get(const std::array<int, 10>& fluidLevels, uint16_t fluidId);
+
+    // 流体的 still/flow 材质,每个流体编号只生成一次;没有流体编号时按 minecraft:water 处理
+    const std::vector<Material>& Materials(uint16_t fluidId);
+
+    // 把邻域描述打包为缓存键(最高位为 1);液位超出 -2..29 或流体编号过大时无法精确打包,返回 0
+    static uint64_t PackKey(const std::array<int, 10>& fluidLevels, uint16_t fluidId);
+
+private:
+    static constexpr size_t kCapacity = size_t(1) << 16;
+    static constexpr size_t kMaxProbe = 64;
+    static constexpr size_t kMaxFluidIds = 65536;
+
+    struct Slot {
+        std::atomic<uint64_t> key{ 0 };           // 0 表示空槽
+        std::atomic<const FluidModel*> model{ nullptr };
+    };
+
+    struct MaterialSet {
+        std::vector<Material> materials;
+        std::vector<uint32_t> materialIds;
+    };
+
+    FluidModelCache(const FluidModelCache&) = delete;
+    FluidModelCache& operator=(const FluidModelCache&) = delete;
+
+    const MaterialSet& GetMaterialSet(uint16_t fluidId);
+    FluidModel Build(const std::array<int, 10>& fluidLevels, uint16_t fluidId);
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::unique_ptr<std::atomic<const MaterialSet*>[]> m_materialSets;
+
+    std::mutex m_overflowMutex;
+    std::map<std::pair<std::array<int, 10>, uint16_t>, std::unique_ptr<FluidModel>> m_overflow;
+};
 
-// 为流体模型分配材质
-void AssignFluidMaterials(ModelData& model, const std::string& fluidId);
+// 全局流体模型缓存
+extern FluidModelCache fluidModels;
 
 #endif // FLUID_H
\ No newline at end of file
@@ -3,8 +3,6 @@
 #include <iostream>
 #include <string>
 
-
-int minSectionY;
 // 计算 YZX 编码后的数字
 int toYZX(int x, int y, int z) {
     int encoded = (y << 8) | (z << 4) | x;
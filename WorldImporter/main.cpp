@@ -4,8 +4,6 @@
 #include "block.h"         // 包含 block.h 以访问缓存及其互斥锁的 extern 声明
 #include "TaskMonitor.h"   // 包含任务监控器头文件
 
-Config config;  // 定义全局变量
-
 using namespace std;
 using namespace chrono;
 
@@ -16,9 +14,8 @@ int main() {
     // 启动内存监控
     // 需要确保 block.cpp 中定义的缓存和互斥锁能够通过 extern 声明被访问
     //MemoryMonitor::StartMonitoring(
-    //    sectionCache, sectionCacheMutex, 
-    //    EntityBlockCache, entityBlockCacheMutex, 
-    //    heightMapCache, heightMapCacheMutex
+    //    sectionGrid, 
+    //    EntityBlockCache, entityBlockCacheMutex
     //);
 
     // 初始化任务监控器
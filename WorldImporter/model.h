@@ -54,7 +54,7 @@ struct Material {
 struct Face {
     std::array<int, 4> vertexIndices; // 四个顶点索引
     std::array<int, 4> uvIndices;     // 四个 UV 索引
-    int materialIndex;                // 材质索引
+    int materialIndex;                // 材质索引:模型中为 materials 的下标,导出网格(MeshBuilder 的结果)中为 materialRegistry 的全局ID
     FaceType faceDirection;           // 剔除方向
 };
 
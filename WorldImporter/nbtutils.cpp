@@ -5,6 +5,7 @@
 #include <cmath>
 #include <unordered_map>
 #include "biome.h"
+#include "BitUnpack.h"
 
 // 将 TagType 转换为字符串的辅助函数
 std::string tagTypeToString(TagType type) {
@@ -27,26 +28,26 @@ std::string tagTypeToString(TagType type) {
 }
 
 // 将字节转换为值的辅助函数
-std::string bytesToString(const std::vector<char>& payload) {
+std::string bytesToString(std::span<const char> payload) {
     return std::string(payload.begin(), payload.end());
 }
 
-int8_t bytesToByte(const std::vector<char>& payload) {
+int8_t bytesToByte(std::span<const char> payload) {
     return static_cast<int8_t>(payload[0]);
 }
 
-int16_t bytesToShort(const std::vector<char>& payload) {
+int16_t bytesToShort(std::span<const char> payload) {
     return (static_cast<uint8_t>(payload[0]) << 8) | static_cast<uint8_t>(payload[1]);
 }
 
-int32_t bytesToInt(const std::vector<char>& payload) {
+int32_t bytesToInt(std::span<const char> payload) {
     return (static_cast<uint8_t>(payload[0]) << 24) |
         (static_cast<uint8_t>(payload[1]) << 16) |
         (static_cast<uint8_t>(payload[2]) << 8) |
         static_cast<uint8_t>(payload[3]);
 }
 
-int64_t bytesToLong(const std::vector<char>& payload) {
+int64_t bytesToLong(std::span<const char> payload) {
     int64_t value = 0;
     for (int i = 0; i < 8; ++i) {
         value = (value << 8) | static_cast<uint8_t>(payload[i]);
@@ -54,15 +55,15 @@ int64_t bytesToLong(const std::vector<char>& payload) {
     return value;
 }
 
-float bytesToFloat(const std::vector<char>& payload) {
-    uint32_t asInt = bytesToInt(std::vector<char>(payload.begin(), payload.begin() + 4));
+float bytesToFloat(std::span<const char> payload) {
+    uint32_t asInt = bytesToInt(payload.first(4));
     float value;
     std::memcpy(&value, &asInt, sizeof(float));
     return value;
 }
 
-double bytesToDouble(const std::vector<char>& payload) {
-    int64_t asLong = bytesToLong(std::vector<char>(payload.begin(), payload.begin() + 8));
+double bytesToDouble(std::span<const char> payload) {
+    int64_t asLong = bytesToLong(payload.first(8));
     double value;
     std::memcpy(&value, &asLong, sizeof(double));
     return value;
@@ -489,7 +490,7 @@ NbtTagPtr readCompoundTag(const std::vector<char>& data, size_t& index) {
 
 
 // 将 payload 字节数组转换为 int 列表(大端顺序,每 4 个字节为一个 int)
-std::vector<int> readIntArray(const std::vector<char>& payload) {
+std::vector<int> readIntArray(std::span<const char> payload) {
     std::vector<int> result;
     // 确保字节数是 4 的倍数
     if (payload.size() % 4 != 0) {
@@ -871,3 +872,393 @@ NbtTagPtr getSectionByIndex(const NbtTagPtr& rootTag, int sectionIndex) {
     std::cerr << "Error: No section found with index " << sectionIndex << std::endl;
     return nullptr;
 }
+
+
+//——————————————基于内存池的零拷贝读取————————————————————
+
+NbtNode* NbtArena::NewNode() {
+    if (m_blockIndex == m_blocks.size()) {
+        m_blocks.push_back(std::make_unique<NbtNode[]>(kNodesPerBlock));
+    }
+    NbtNode* node = &m_blocks[m_blockIndex][m_used];
+    *node = NbtNode();
+    if (++m_used == kNodesPerBlock) {
+        ++m_blockIndex;
+        m_used = 0;
+    }
+    return node;
+}
+
+void NbtArena::Reset() {
+    m_blockIndex = 0;
+    m_used = 0;
+}
+
+NbtArena& NbtArena::ForThread() {
+    thread_local NbtArena arena;
+    return arena;
+}
+
+namespace {
+    inline int32_t readLength(std::span<const char> data, size_t& index, const char* what) {
+        if (index + 4 > data.size()) throw std::out_of_range(what);
+        int32_t length = bytesToInt(data.subspan(index, 4));
+        index += 4;
+        if (length < 0) throw std::out_of_range(what);
+        return length;
+    }
+
+    // 负载视图:检查长度后返回 [index, index+size) 并前进
+    inline std::span<const char> takeBytes(std::span<const char> data, size_t& index, size_t size, const char* what) {
+        if (index + size > data.size()) throw std::out_of_range(what);
+        auto view = data.subspan(index, size);
+        index += size;
+        return view;
+    }
+
+    // schema 为 nullptr 时完整解析子树
+    void readNodePayload(std::span<const char> data, size_t& index, NbtNode* node, NbtArena& arena, const NbtSchema* schema);
+
+    // 读取名称与负载,遇到 TAG_End 返回 nullptr;不在模式中的标签被跳过并以 skipped=true 返回 nullptr
+    NbtNode* readNamedNode(std::span<const char> data, size_t& index, NbtArena& arena, const NbtSchema* parentSchema, bool& skipped) {
+        skipped = false;
+        if (index >= data.size()) {
+            throw std::out_of_range("Index out of bounds while reading tag type");
+        }
+        TagType type = static_cast<TagType>(static_cast<uint8_t>(data[index]));
+        index++;
+        if (type == TagType::END) {
+            return nullptr;
+        }
+
+        if (index + 2 > data.size()) throw std::out_of_range("Not enough data to read tag name length");
+        uint16_t nameLength = static_cast<uint16_t>(bytesToShort(data.subspan(index, 2)));
+        index += 2;
+        auto nameBytes = takeBytes(data, index, nameLength, "Not enough data to read tag name");
+        std::string_view name(nameBytes.data(), nameBytes.size());
+
+        const NbtSchema* schema = nullptr;
+        if (parentSchema) {
+            schema = parentSchema->Find(name);
+            if (!schema) {
+                skipTagPayload(data, index, type);
+                skipped = true;
+                return nullptr;
+            }
+            if (schema->KeepAll()) schema = nullptr;
+        }
+
+        NbtNode* node = arena.NewNode();
+        node->type = type;
+        node->name = name;
+        readNodePayload(data, index, node, arena, schema);
+        return node;
+    }
+
+    void readNodePayload(std::span<const char> data, size_t& index, NbtNode* node, NbtArena& arena, const NbtSchema* schema) {
+        switch (node->type) {
+        case TagType::BYTE:
+            node->payload = takeBytes(data, index, 1, "Not enough data for TAG_Byte");
+            break;
+        case TagType::SHORT:
+            node->payload = takeBytes(data, index, 2, "Not enough data for TAG_Short");
+            break;
+        case TagType::INT:
+        case TagType::FLOAT:
+            node->payload = takeBytes(data, index, 4, "Not enough data for TAG_Int/TAG_Float");
+            break;
+        case TagType::LONG:
+        case TagType::DOUBLE:
+            node->payload = takeBytes(data, index, 8, "Not enough data for TAG_Long/TAG_Double");
+            break;
+        case TagType::BYTE_ARRAY: {
+            int32_t length = readLength(data, index, "Not enough data for TAG_Byte_Array length");
+            node->payload = takeBytes(data, index, static_cast<size_t>(length), "Not enough data for TAG_Byte_Array payload");
+            break;
+        }
+        case TagType::INT_ARRAY: {
+            int32_t length = readLength(data, index, "Not enough data for TAG_Int_Array length");
+            node->payload = takeBytes(data, index, static_cast<size_t>(length) * 4, "Not enough data for TAG_Int_Array payload");
+            break;
+        }
+        case TagType::LONG_ARRAY: {
+            int32_t length = readLength(data, index, "Not enough data for TAG_Long_Array length");
+            node->payload = takeBytes(data, index, static_cast<size_t>(length) * 8, "Not enough data for TAG_Long_Array payload");
+            break;
+        }
+        case TagType::STRING: {
+            if (index + 2 > data.size()) throw std::out_of_range("Not enough data to read string length");
+            uint16_t length = static_cast<uint16_t>(bytesToShort(data.subspan(index, 2)));
+            index += 2;
+            node->payload = takeBytes(data, index, length, "Not enough data to read string content");
+            break;
+        }
+        case TagType::LIST: {
+            if (index >= data.size()) throw std::out_of_range("Index out of bounds while reading TAG_List element type");
+            node->listType = static_cast<TagType>(static_cast<uint8_t>(data[index++]));
+            int32_t length = readLength(data, index, "Not enough data to read TAG_List length");
+            if (length > 0 && node->listType == TagType::END) {
+                throw std::runtime_error("TAG_List cannot have TAG_End elements");
+            }
+            // LIST 元素沿用当前模式
+            NbtNode* last = nullptr;
+            for (int32_t i = 0; i < length; ++i) {
+                NbtNode* elem = arena.NewNode();
+                elem->type = node->listType;
+                readNodePayload(data, index, elem, arena, schema);
+                if (last) last->nextSibling = elem; else node->firstChild = elem;
+                last = elem;
+            }
+            node->childCount = static_cast<uint32_t>(length);
+            break;
+        }
+        case TagType::COMPOUND: {
+            NbtNode* last = nullptr;
+            bool skipped = false;
+            while (true) {
+                NbtNode* child = readNamedNode(data, index, arena, schema, skipped);
+                if (!child) {
+                    if (skipped) continue;
+                    break;
+                }
+                if (last) last->nextSibling = child; else node->firstChild = child;
+                last = child;
+                node->childCount++;
+            }
+            break;
+        }
+        default:
+            throw std::runtime_error("Unsupported tag type: " + std::to_string(static_cast<int>(node->type)));
+        }
+    }
+
+    // 定长类型的负载字节数,变长类型返回 0
+    inline size_t fixedPayloadSize(TagType type) {
+        switch (type) {
+        case TagType::BYTE: return 1;
+        case TagType::SHORT: return 2;
+        case TagType::INT:
+        case TagType::FLOAT: return 4;
+        case TagType::LONG:
+        case TagType::DOUBLE: return 8;
+        default: return 0;
+        }
+    }
+}
+
+void skipTagPayload(std::span<const char> data, size_t& index, TagType type) {
+    if (size_t fixed = fixedPayloadSize(type)) {
+        takeBytes(data, index, fixed, "Not enough data to skip tag");
+        return;
+    }
+    switch (type) {
+    case TagType::BYTE_ARRAY:
+        takeBytes(data, index, static_cast<size_t>(readLength(data, index, "Not enough data to skip TAG_Byte_Array")), "Not enough data to skip TAG_Byte_Array");
+        break;
+    case TagType::INT_ARRAY:
+        takeBytes(data, index, static_cast<size_t>(readLength(data, index, "Not enough data to skip TAG_Int_Array")) * 4, "Not enough data to skip TAG_Int_Array");
+        break;
+    case TagType::LONG_ARRAY:
+        takeBytes(data, index, static_cast<size_t>(readLength(data, index, "Not enough data to skip TAG_Long_Array")) * 8, "Not enough data to skip TAG_Long_Array");
+        break;
+    case TagType::STRING: {
+        if (index + 2 > data.size()) throw std::out_of_range("Not enough data to skip string length");
+        uint16_t length = static_cast<uint16_t>(bytesToShort(data.subspan(index, 2)));
+        index += 2;
+        takeBytes(data, index, length, "Not enough data to skip string");
+        break;
+    }
+    case TagType::LIST: {
+        if (index >= data.size()) throw std::out_of_range("Index out of bounds while skipping TAG_List");
+        TagType listType = static_cast<TagType>(static_cast<uint8_t>(data[index++]));
+        int32_t length = readLength(data, index, "Not enough data to skip TAG_List length");
+        if (size_t fixed = fixedPayloadSize(listType)) {
+            // 定长元素一次跳过
+            takeBytes(data, index, fixed * static_cast<size_t>(length), "Not enough data to skip TAG_List");
+        } else {
+            for (int32_t i = 0; i < length; ++i) {
+                skipTagPayload(data, index, listType);
+            }
+        }
+        break;
+    }
+    case TagType::COMPOUND: {
+        while (true) {
+            if (index >= data.size()) throw std::out_of_range("Index out of bounds while skipping TAG_Compound");
+            TagType childType = static_cast<TagType>(static_cast<uint8_t>(data[index++]));
+            if (childType == TagType::END) break;
+            if (index + 2 > data.size()) throw std::out_of_range("Not enough data to skip tag name");
+            uint16_t nameLength = static_cast<uint16_t>(bytesToShort(data.subspan(index, 2)));
+            index += 2;
+            takeBytes(data, index, nameLength, "Not enough data to skip tag name");
+            skipTagPayload(data, index, childType);
+        }
+        break;
+    }
+    default:
+        throw std::runtime_error("Unsupported tag type: " + std::to_string(static_cast<int>(type)));
+    }
+}
+
+NbtSchema::NbtSchema(std::initializer_list<std::string_view> paths) {
+    for (std::string_view path : paths) {
+        AddPath(path);
+    }
+}
+
+void NbtSchema::AddPath(std::string_view path) {
+    NbtSchema* current = this;
+    while (!path.empty()) {
+        size_t slash = path.find('/');
+        std::string_view head = path.substr(0, slash);
+        path = (slash == std::string_view::npos) ? std::string_view() : path.substr(slash + 1);
+
+        NbtSchema* next = nullptr;
+        for (auto& child : current->m_children) {
+            if (child.first == head) {
+                next = child.second.get();
+                break;
+            }
+        }
+        if (!next) {
+            current->m_children.emplace_back(std::string(head), std::make_unique<NbtSchema>());
+            next = current->m_children.back().second.get();
+            // 新建的末端节点默认保留整个子树,继续向下细化时取消
+            next->m_keepAll = true;
+        }
+        if (!path.empty()) {
+            // 还有更深的路径:若此前作为末端保留整个子树,且没有其他子路径,则改为按子路径筛选
+            if (next->m_keepAll && next->m_children.empty()) {
+                next->m_keepAll = false;
+            }
+        }
+        current = next;
+    }
+}
+
+const NbtSchema* NbtSchema::Find(std::string_view name) const {
+    for (const auto& child : m_children) {
+        if (child.first == name) {
+            return child.second.get();
+        }
+    }
+    return nullptr;
+}
+
+const NbtNode* readTag(std::span<const char> data, size_t& index, NbtArena& arena) {
+    bool skipped = false;
+    return readNamedNode(data, index, arena, nullptr, skipped);
+}
+
+const NbtNode* readTag(std::span<const char> data, size_t& index, NbtArena& arena, const NbtSchema& schema) {
+    if (index >= data.size()) {
+        throw std::out_of_range("Index out of bounds while reading tag type");
+    }
+    TagType type = static_cast<TagType>(static_cast<uint8_t>(data[index]));
+    index++;
+    if (type == TagType::END) {
+        return nullptr;
+    }
+    if (index + 2 > data.size()) throw std::out_of_range("Not enough data to read tag name length");
+    uint16_t nameLength = static_cast<uint16_t>(bytesToShort(data.subspan(index, 2)));
+    index += 2;
+    auto nameBytes = takeBytes(data, index, nameLength, "Not enough data to read tag name");
+
+    // 根标签本身总是保留,模式作用于其子标签
+    NbtNode* node = arena.NewNode();
+    node->type = type;
+    node->name = std::string_view(nameBytes.data(), nameBytes.size());
+    readNodePayload(data, index, node, arena, schema.KeepAll() ? nullptr : &schema);
+    return node;
+}
+
+const NbtNode* getChildByName(const NbtNode* tag, std::string_view childName) {
+    if (!tag || tag->type != TagType::COMPOUND) {
+        return nullptr;
+    }
+    for (const NbtNode* child : tag->children()) {
+        if (child->name == childName) {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view getStringView(const NbtNode* tag) {
+    if (!tag || tag->type != TagType::STRING) {
+        return {};
+    }
+    return std::string_view(tag->payload.data(), tag->payload.size());
+}
+
+const NbtNode* getBiomes(const NbtNode* sectionTag) {
+    return getChildByName(sectionTag, "biomes");
+}
+
+std::vector<std::string> getBiomePalette(const NbtNode* biomesTag) {
+    auto paletteTag = getChildByName(biomesTag, "palette");
+    if (!paletteTag || paletteTag->type != TagType::LIST) {
+        throw std::runtime_error("No valid palette tag found in biomes.");
+    }
+
+    std::vector<std::string> palette;
+    palette.reserve(paletteTag->childCount);
+    for (const NbtNode* child : paletteTag->children()) {
+        if (child->type == TagType::STRING) {
+            palette.emplace_back(getStringView(child));
+        }
+    }
+    return palette;
+}
+
+const NbtNode* getBlockStates(const NbtNode* sectionTag) {
+    return getChildByName(sectionTag, "block_states");
+}
+
+std::vector<std::string> getBlockPalette(const NbtNode* blockStatesTag) {
+    std::vector<std::string> blockPalette;
+
+    auto paletteTag = getChildByName(blockStatesTag, "palette");
+    if (!paletteTag || paletteTag->type != TagType::LIST) {
+        return blockPalette;
+    }
+    blockPalette.reserve(paletteTag->childCount);
+    for (const NbtNode* blockTag : paletteTag->children()) {
+        if (blockTag->type != TagType::COMPOUND) continue;
+
+        std::string blockName(getStringView(getChildByName(blockTag, "Name")));
+
+        // 检查是否有 Properties,拼接后缀
+        auto propertiesTag = getChildByName(blockTag, "Properties");
+        if (propertiesTag && propertiesTag->type == TagType::COMPOUND) {
+            bool first = true;
+            for (const NbtNode* property : propertiesTag->children()) {
+                if (property->type != TagType::STRING) continue;
+                blockName += first ? '[' : ',';
+                blockName += property->name;
+                blockName += ':';
+                blockName += getStringView(property);
+                first = false;
+            }
+            if (!first) {
+                blockName += ']';
+            }
+        }
+        blockPalette.push_back(std::move(blockName));
+    }
+    return blockPalette;
+}
+
+std::vector<int> getBlockStatesData(const NbtNode* blockStatesTag, const std::vector<std::string>& blockPalette) {
+    const int totalBlocks = 4096;
+    std::vector<int> blockStatesData(totalBlocks, 0);
+
+    auto dataTag = getChildByName(blockStatesTag, "data");
+    if (!dataTag || dataTag->type != TagType::LONG_ARRAY) {
+        return blockStatesData;
+    }
+
+    // 直接从负载解包,不再复制并反转整个 long 数组
+    BitUnpack::Unpack(dataTag->payload, BitUnpack::BlockStateBits(blockPalette.size()), totalBlocks, blockStatesData.data());
+    return blockStatesData;
+}
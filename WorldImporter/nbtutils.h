@@ -8,6 +8,9 @@
 #include <cstdint>
 #include <cstring>
 #include <vector>
+#include <span>
+#include <string_view>
+#include <initializer_list>
 #include <type_traits>  // 用于 std::is_integral
 
 // NBT Tag Types 枚举,表示不同的NBT标签类型
@@ -98,27 +101,28 @@ NbtTagPtr readListTag(const std::vector<char>& data, size_t& index);
 // 函数声明:读取COMPOUND类型标签并更新索引位置
 NbtTagPtr readCompoundTag(const std::vector<char>& data, size_t& index);
 
-std::vector<int> readIntArray(const std::vector<char>& payload);
+std::vector<int> readIntArray(std::span<const char> payload);
+// 以下 bytesToXxx 同时接受 NbtTag::payload(vector) 与 NbtNode::payload(span)
 // 帮助函数:将字节数组转换为可读的字符串
-std::string bytesToString(const std::vector<char>& payload);
+std::string bytesToString(std::span<const char> payload);
 
 // 帮助函数:将字节数组转换为字节类型(8位有符号整数)
-int8_t bytesToByte(const std::vector<char>& payload);
+int8_t bytesToByte(std::span<const char> payload);
 
 // 帮助函数:将字节数组转换为短整型(16位有符号整数)
-int16_t bytesToShort(const std::vector<char>& payload);
+int16_t bytesToShort(std::span<const char> payload);
 
 // 帮助函数:将字节数组转换为整型(32位有符号整数)
-int32_t bytesToInt(const std::vector<char>& payload);
+int32_t bytesToInt(std::span<const char> payload);
 
 // 帮助函数:将字节数组转换为长整型(64位有符号整数)
-int64_t bytesToLong(const std::vector<char>& payload);
+int64_t bytesToLong(std::span<const char> payload);
 
 // 帮助函数:将字节数组转换为浮动精度数(32位浮动精度数)
-float bytesToFloat(const std::vector<char>& payload);
+float bytesToFloat(std::span<const char> payload);
 
 // 帮助函数:将字节数组转换为双精度浮动数(64位浮动精度数)
-double bytesToDouble(const std::vector<char>& payload);
+double bytesToDouble(std::span<const char> payload);
 
 long long reverseEndian(long long value);
 
@@ -157,4 +161,110 @@ std::vector<std::string> getBlockPalette(const NbtTagPtr& blockStatesTag);
 std::vector<int> getBlockStatesData(const NbtTagPtr& blockStatesTag, const std::vector<std::string>& blockPalette);
 
 NbtTagPtr getSectionByIndex(const NbtTagPtr& rootTag, int sectionIndex);
+
+//——————————————基于内存池的零拷贝读取————————————————————
+// NbtNode 不拥有任何数据:名称与负载都指向解压后的缓冲区,节点本身分配在 NbtArena 中。
+// 因此节点只在缓冲区未被修改且 arena 未 Reset 之前有效。
+
+struct NbtNode;
+
+// 子节点遍历范围,支持 for (const NbtNode* child : node->children())
+struct NbtChildRange {
+    struct Iterator {
+        const NbtNode* node;
+        const NbtNode* operator*() const { return node; }
+        Iterator& operator++();
+        bool operator!=(const Iterator& other) const { return node != other.node; }
+    };
+    const NbtNode* first;
+    Iterator begin() const { return { first }; }
+    Iterator end() const { return { nullptr }; }
+};
+
+struct NbtNode {
+    TagType type = TagType::END;        // 标签的类型
+    TagType listType = TagType::END;    // LIST标签中元素的类型
+    std::string_view name;              // 标签名称(LIST元素为空)
+    std::span<const char> payload;      // 原始大端负载;STRING 为字符串内容,数组为元素字节
+    NbtNode* firstChild = nullptr;      // COMPOUND/LIST 的第一个子节点
+    NbtNode* nextSibling = nullptr;     // 下一个兄弟节点
+    uint32_t childCount = 0;            // 子节点数量
+
+    NbtChildRange children() const { return { firstChild }; }
+};
+
+inline NbtChildRange::Iterator& NbtChildRange::Iterator::operator++() {
+    node = node->nextSibling;
+    return *this;
+}
+
+// 节点内存池:按块分配 NbtNode,Reset 后复用已分配的块
+class NbtArena {
+public:
+    NbtNode* NewNode();
+
+    // 释放所有节点(保留已分配的内存块)
+    void Reset();
+
+    // 当前线程的内存池
+    static NbtArena& ForThread();
+
+private:
+    static constexpr size_t kNodesPerBlock = 4096;
+    std::vector<std::unique_ptr<NbtNode[]>> m_blocks;
+    size_t m_blockIndex = 0;
+    size_t m_used = 0;
+};
+
+// 编译后的提取模式:描述需要保留的标签路径,其余子树在解析时按长度前缀直接跳过,不分配节点。
+// 路径用 '/' 分隔,例如 "sections/block_states";LIST 中的复合元素沿用同一层模式。
+// 路径末端的标签会被完整解析。
+class NbtSchema {
+public:
+    NbtSchema() = default;
+    NbtSchema(std::initializer_list<std::string_view> paths);
+
+    // 添加一条需要保留的路径
+    void AddPath(std::string_view path);
+
+    // 查找子标签对应的模式,返回 nullptr 表示跳过该子标签
+    const NbtSchema* Find(std::string_view name) const;
+
+    // 是否保留整个子树
+    bool KeepAll() const { return m_keepAll; }
+
+private:
+    bool m_keepAll = false;
+    std::vector<std::pair<std::string, std::unique_ptr<NbtSchema>>> m_children;
+};
+
+// 从索引处读取一个命名标签(零拷贝),遇到 TAG_End 返回 nullptr
+const NbtNode* readTag(std::span<const char> data, size_t& index, NbtArena& arena);
+
+// 按提取模式读取一个命名标签,模式之外的子树被跳过
+const NbtNode* readTag(std::span<const char> data, size_t& index, NbtArena& arena, const NbtSchema& schema);
+
+// 跳过一个指定类型的负载(不分配内存)
+void skipTagPayload(std::span<const char> data, size_t& index, TagType type);
+
+// 通过名字获取子级节点
+const NbtNode* getChildByName(const NbtNode* tag, std::string_view childName);
+
+// 获取 STRING 节点的内容
+std::string_view getStringView(const NbtNode* tag);
+
+// 获取 section 下的 biomes 节点
+const NbtNode* getBiomes(const NbtNode* sectionTag);
+
+// 获取 biomes 下的 palette 列表
+std::vector<std::string> getBiomePalette(const NbtNode* biomesTag);
+
+// 获取 section 下的 block_states 节点
+const NbtNode* getBlockStates(const NbtNode* sectionTag);
+
+// 读取 block_states 的 palette 数据
+std::vector<std::string> getBlockPalette(const NbtNode* blockStatesTag);
+
+// 解析 block_states 的 data 数据
+std::vector<int> getBlockStatesData(const NbtNode* blockStatesTag, const std::vector<std::string>& blockPalette);
 #endif // NBTUTILS_H
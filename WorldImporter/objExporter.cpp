@@ -1,4 +1,6 @@
 #include "objExporter.h"
+#include "MaterialRegistry.h"
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <sstream>
@@ -239,7 +241,8 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     }
 
     // 面数据分组计算
-    std::vector<std::vector<size_t>> materialGroups(data.materials.size());
+    // 面的材质索引为 materialRegistry 中的全局ID
+    std::vector<std::vector<size_t>> materialGroups(materialRegistry.Size());
     const size_t totalFaces = data.faces.size();
     for (size_t faceIdx = 0; faceIdx < totalFaces; ++faceIdx) {
         const int matIndex = data.faces[faceIdx].materialIndex;
@@ -252,17 +255,11 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     totalSize += snprintf(nullptr, 0, "\n# Faces (%zu)\n", totalFaces);
 
     // 预计算材质组内每个材质对应的usemtl行以及各个面的长度
-    std::vector<size_t> usemtlLengths(data.materials.size());
-#pragma omp parallel for
-    for (int matIndex = 0; matIndex < data.materials.size(); ++matIndex) {
-        usemtlLengths[matIndex] = 8 + data.materials[matIndex].name.size() + 1; // "usemtl " + name + "\n"
-    }
-
 #pragma omp parallel for reduction(+:totalSize)
     for (int matIndex = 0; matIndex < materialGroups.size(); ++matIndex) {
         const auto& faces = materialGroups[matIndex];
         if (faces.empty()) continue;
-        size_t localSize = usemtlLengths[matIndex];
+        size_t localSize = 8 + materialRegistry.Get(matIndex).name.size() + 1; // "usemtl " + name + "\n"
         for (const size_t faceIdx : faces) {
             size_t faceLength = 3; // "f " + '\n'
             const auto& vertexIndices = data.faces[faceIdx].vertexIndices;
@@ -310,7 +307,7 @@ void createObjFileViaMemoryMapped(const ModelData& data, const std::string& objN
     for (size_t matIndex = 0; matIndex < materialGroups.size(); ++matIndex) {
         const auto& faces = materialGroups[matIndex];
         if (faces.empty()) continue;
-        ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "usemtl %s\n", data.materials[matIndex].name.c_str());
+        ptr += snprintf(ptr, buffer.size() - (ptr - buffer.data()), "usemtl %s\n", materialRegistry.Get(matIndex).name.c_str());
         for (const size_t faceIdx : faces) {
             memcpy(ptr, "f ", 2);
             ptr += 2;
@@ -424,7 +421,8 @@ void createObjFile(const ModelData& data, const std::string& objName, const std:
     oss << "\n";
 
     // 按材质分组面(优化分组算法)
-    std::vector<std::vector<size_t>> materialGroups(data.materials.size());
+    // 面的材质索引为 materialRegistry 中的全局ID
+    std::vector<std::vector<size_t>> materialGroups(materialRegistry.Size());
     const size_t totalFaces = data.faces.size();
     for (size_t faceIdx = 0; faceIdx < totalFaces; ++faceIdx) {
         const int matIndex = data.faces[faceIdx].materialIndex;
@@ -439,7 +437,7 @@ void createObjFile(const ModelData& data, const std::string& objName, const std:
         const auto& faces = materialGroups[matIndex];
         if (faces.empty()) continue;
 
-        oss << "usemtl " << data.materials[matIndex].name << "\n";
+        oss << "usemtl " << materialRegistry.Get(matIndex).name << "\n";
         for (const size_t faceIdx : faces) {
             oss << "f ";
             for (int i = 0; i < 4; ++i) {
@@ -462,83 +460,106 @@ void createObjFile(const ModelData& data, const std::string& objName, const std:
     }
 }
 
-void CreateSharedMtlFile(std::unordered_map<std::string, std::string> uniqueMaterials, const std::string& mtlFileName) {
+// 写出一个材质的 MTL 条目
+static void WriteMtlEntry(std::ofstream& mtlFile, const Material& material, const std::string& mtlFileName) {
+    const std::string& textureName = material.name;
+    std::string texturePath = material.texturePath;
+
+    mtlFile << "newmtl " << textureName << "\n";
+
+    // 处理材质类型
+    if (texturePath == "None") {
+        // LIGHT材质处理
+        mtlFile << "Ns 200.000000\n";
+        mtlFile << "Kd 1.000000 1.000000 1.000000\n";
+        mtlFile << "Ka 1.000000 1.000000 1.000000\n";
+        mtlFile << "Ks 0.900000 0.900000 0.900000\n";
+        mtlFile << "Ke 0.900000 0.900000 0.900000\n";
+        mtlFile << "Ni 1.500000\n";
+        mtlFile << "illum 2\n";
+    }
+    // 处理纯颜色材质(支持流体格式:color#r g b-流体名 和普通格式:color#r g b=)
+    else if (texturePath.find("color#") != std::string::npos) {
+        std::string colorStr;
+        size_t pos = texturePath.find("-");
+        size_t pos_deng = texturePath.find("=");
+        if (pos != std::string::npos) {
+            // 流体材质格式,提取"-"前面的颜色部分
+            colorStr = texturePath.substr(std::string("color#").size(), pos - std::string("color#").size());
+        }
+        else if (pos_deng != std::string::npos) {
+            colorStr = texturePath.substr(std::string("color#").size(), pos_deng - std::string("color#").size());
+        }
+        else {
+            colorStr = "";
+        }
+        std::istringstream iss(colorStr);
+        float r, g, b;
+        if (iss >> r >> g >> b) {
+            mtlFile << "Kd " << std::fixed << std::setprecision(config.decimalPlaces)
+                << r << " " << g << " " << b << "\n";
+        }
+        else {
+            mtlFile << "Kd 1.000000 1.000000 1.000000\n";
+            std::cerr << "Error: Invalid color format in '" << texturePath << "'\n";
+        }
+        // 共用普通材质参数
+        mtlFile << "Ns 90.000000\n";
+        mtlFile << "Ks 0.000000 0.000000 0.000000\n";
+        mtlFile << "Ke 0.000000 0.000000 0.000000\n";
+        mtlFile << "Ni 1.500000\n";
+        mtlFile << "illum 1\n";
+    }
+    else {
+        // 普通纹理材质处理
+        mtlFile << "Ns 90.000000\n";
+        mtlFile << "Kd 1.000000 1.000000 1.000000\n";
+        mtlFile << "Ks 0.000000 0.000000 0.000000\n";
+        mtlFile << "Ke 0.000000 0.000000 0.000000\n";
+        mtlFile << "Ni 1.500000\n";
+        mtlFile << "illum 1\n";
+
+        // 处理纹理路径
+        if (mtlFileName.find("//") != std::string::npos) {
+            texturePath = "../" + texturePath;
+        }
+        if (texturePath.find(".png") == std::string::npos) {
+            texturePath += ".png";
+        }
+        mtlFile << "map_Kd " << texturePath << "\n";
+        mtlFile << "map_d " << texturePath << "\n";
+    }
+
+    mtlFile << "\n";
+}
+
+// 导出网格中用到的全局材质ID,按ID排序
+static std::vector<uint32_t> CollectMaterialIds(const ModelData& data) {
+    std::vector<bool> used(materialRegistry.Size(), false);
+    for (const auto& face : data.faces) {
+        if (face.materialIndex >= 0 && static_cast<size_t>(face.materialIndex) < used.size()) {
+            used[face.materialIndex] = true;
+        }
+    }
+    std::vector<uint32_t> ids;
+    for (size_t id = 0; id < used.size(); ++id) {
+        if (used[id]) ids.push_back(static_cast<uint32_t>(id));
+    }
+    return ids;
+}
+
+void CreateSharedMtlFile(const std::unordered_set<uint32_t>& materialIds, const std::string& mtlFileName) {
     std::string exeDir = getExecutableDir();
     std::string fullMtlPath = exeDir + mtlFileName + ".mtl";
 
+    // 按ID顺序写出,输出稳定
+    std::vector<uint32_t> sortedIds(materialIds.begin(), materialIds.end());
+    std::sort(sortedIds.begin(), sortedIds.end());
+
     std::ofstream mtlFile(fullMtlPath);
     if (mtlFile.is_open()) {
-        for (const auto& uM : uniqueMaterials) {
-            const std::string& textureName = uM.first;
-            std::string texturePath = uM.second;
-
-            mtlFile << "newmtl " << textureName << "\n";
-
-            // 处理材质类型
-            if (texturePath == "None") {
-                // LIGHT材质处理
-                mtlFile << "Ns 200.000000\n";
-                mtlFile << "Kd 1.000000 1.000000 1.000000\n";
-                mtlFile << "Ka 1.000000 1.000000 1.000000\n";
-                mtlFile << "Ks 0.900000 0.900000 0.900000\n";
-                mtlFile << "Ke 0.900000 0.900000 0.900000\n";
-                mtlFile << "Ni 1.500000\n";
-                mtlFile << "illum 2\n";
-            }
-            // 处理纯颜色材质(支持流体格式:color#r g b-流体名 和普通格式:color#r g b=)
-            else if (texturePath.find("color#") != std::string::npos) {
-                std::string colorStr;
-                size_t pos = texturePath.find("-");
-                size_t pos_deng = texturePath.find("=");
-                if (pos != std::string::npos) {
-                    // 流体材质格式,提取"-"前面的颜色部分
-                    colorStr = texturePath.substr(std::string("color#").size(), pos - std::string("color#").size());
-                }
-                else if (pos_deng != std::string::npos) {
-                    colorStr = texturePath.substr(std::string("color#").size(), pos_deng - std::string("color#").size());
-                }
-                else {
-                    colorStr = "";
-                }
-                std::istringstream iss(colorStr);
-                float r, g, b;
-                if (iss >> r >> g >> b) {
-
-                    mtlFile << "Kd " << std::fixed << std::setprecision(config.decimalPlaces)
-                        << r << " " << g << " " << b << "\n";
-                }
-                else {
-                    mtlFile << "Kd 1.000000 1.000000 1.000000\n";
-                    std::cerr << "Error: Invalid color format in '" << texturePath << "'\n";
-                }
-                // 共用普通材质参数
-                mtlFile << "Ns 90.000000\n";
-                mtlFile << "Ks 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ke 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ni 1.500000\n";
-                mtlFile << "illum 1\n";
-            }
-            else {
-                // 普通纹理材质处理
-                mtlFile << "Ns 90.000000\n";
-                mtlFile << "Kd 1.000000 1.000000 1.000000\n";
-                mtlFile << "Ks 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ke 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ni 1.500000\n";
-                mtlFile << "illum 1\n";
-
-                // 处理纹理路径
-                if (mtlFileName.find("//") != std::string::npos) {
-                    texturePath = "../" + texturePath;
-                }
-                if (texturePath.find(".png") == std::string::npos) {
-                    texturePath += ".png";
-                }
-                mtlFile << "map_Kd " << texturePath << "\n";
-                mtlFile << "map_d " << texturePath << "\n";
-            }
-
-            mtlFile << "\n";
+        for (uint32_t id : sortedIds) {
+            WriteMtlEntry(mtlFile, materialRegistry.Get(id), mtlFileName);
         }
         mtlFile.close();
     }
@@ -547,83 +568,15 @@ void CreateSharedMtlFile(std::unordered_map<std::string, std::string> uniqueMate
     }
 }
 
-// 创建 .mtl 文件,接收 textureToPath 作为参数
+// 创建 .mtl 文件,只包含网格中用到的材质
 void createMtlFile(const ModelData& data, const std::string& mtlFileName) {
     std::string exeDir = getExecutableDir();
     std::string fullMtlPath = exeDir + mtlFileName + ".mtl";
 
     std::ofstream mtlFile(fullMtlPath);
     if (mtlFile.is_open()) {
-        for (size_t i = 0; i < data.materials.size(); ++i) {
-            const std::string& textureName = data.materials[i].name;
-            std::string texturePath = data.materials[i].texturePath;
-
-            mtlFile << "newmtl " << textureName << "\n";
-
-            // 处理材质类型
-            if (texturePath == "None") {
-                // LIGHT材质处理
-                mtlFile << "Ns 200.000000\n";
-                mtlFile << "Kd 1.000000 1.000000 1.000000\n";
-                mtlFile << "Ka 1.000000 1.000000 1.000000\n";
-                mtlFile << "Ks 0.900000 0.900000 0.900000\n";
-                mtlFile << "Ke 0.900000 0.900000 0.900000\n";
-                mtlFile << "Ni 1.500000\n";
-                mtlFile << "illum 2\n";
-            }
-            // 处理纯颜色材质(支持流体格式:color#r g b-流体名 和普通格式:color#r g b=)
-            else if (texturePath.find("color#") != std::string::npos) {
-                std::string colorStr;
-                size_t pos = texturePath.find("-");
-                size_t pos_deng = texturePath.find("=");
-                if (pos != std::string::npos) {
-                    // 流体材质格式,提取"-"前面的颜色部分
-                    colorStr = texturePath.substr(std::string("color#").size(), pos - std::string("color#").size());
-                }
-                else if (pos_deng != std::string::npos) {
-                    colorStr = texturePath.substr(std::string("color#").size(), pos_deng - std::string("color#").size());
-                }
-                else {
-                    colorStr = "";
-                }
-                std::istringstream iss(colorStr);
-                float r, g, b;
-                if (iss >> r >> g >> b) {
-                    mtlFile << "Kd " << std::fixed << std::setprecision(config.decimalPlaces)
-                        << r << " " << g << " " << b << "\n";
-                }
-                else {
-                    mtlFile << "Kd 1.000000 1.000000 1.000000\n";
-                    std::cerr << "Error: Invalid color format in '" << texturePath << "'\n";
-                }
-                // 共用普通材质参数
-                mtlFile << "Ns 90.000000\n";
-                mtlFile << "Ks 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ke 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ni 1.500000\n";
-                mtlFile << "illum 1\n";
-            }
-            else {
-                // 普通纹理材质处理
-                mtlFile << "Ns 90.000000\n";
-                mtlFile << "Kd 1.000000 1.000000 1.000000\n";
-                mtlFile << "Ks 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ke 0.000000 0.000000 0.000000\n";
-                mtlFile << "Ni 1.500000\n";
-                mtlFile << "illum 1\n";
-
-                // 处理纹理路径
-                if (mtlFileName.find("//") != std::string::npos) {
-                    texturePath = "../" + texturePath;
-                }
-                if (texturePath.find(".png") == std::string::npos) {
-                    texturePath += ".png";
-                }
-                mtlFile << "map_Kd " << texturePath << "\n";
-                mtlFile << "map_d " << texturePath << "\n";
-            }
-
-            mtlFile << "\n";
+        for (uint32_t id : CollectMaterialIds(data)) {
+            WriteMtlEntry(mtlFile, materialRegistry.Get(id), mtlFileName);
         }
         mtlFile.close();
     }
@@ -666,7 +619,7 @@ void CreateModelFiles(const ModelData& data, const std::string& filename) {
 
 //多个obj文件创建方法
 void CreateMultiModelFiles(const ModelData& data, const std::string& filename,
-    std::unordered_map<std::string, std::string>& uniqueMaterialsL,
+    std::unordered_set<uint32_t>& usedMaterials,
     const std::string& sharedMtlName) { // 新增共享mtl名称参数
     auto start = high_resolution_clock::now();
 
@@ -678,8 +631,8 @@ void CreateMultiModelFiles(const ModelData& data, const std::string& filename,
     }
 
     // 收集材质信息
-    for (size_t i = 0; i < data.materials.size(); ++i) {
-        uniqueMaterialsL[data.materials[i].name] = data.materials[i].texturePath;
+    for (uint32_t id : CollectMaterialIds(data)) {
+        usedMaterials.insert(id);
     }
 
     auto end = high_resolution_clock::now();
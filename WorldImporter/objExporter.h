@@ -18,11 +18,12 @@
 // 文件导出
 void CreateModelFiles(const ModelData& data, const std::string& filename);
 
+// usedMaterials 中追加该网格用到的全局材质ID,供 CreateSharedMtlFile 使用
 void CreateMultiModelFiles(const ModelData& data, const std::string& filename,
-    std::unordered_map<std::string, std::string>& uniqueMaterialsL,
+    std::unordered_set<uint32_t>& usedMaterials,
     const std::string& sharedMtlName);
 
 
 // 在ObjExporter.h中添加新函数声明
-void CreateSharedMtlFile(std::unordered_map<std::string, std::string> uniqueMaterials, const std::string& mtlFileName);
+void CreateSharedMtlFile(const std::unordered_set<uint32_t>& materialIds, const std::string& mtlFileName);
 #endif
\ No newline at end of file
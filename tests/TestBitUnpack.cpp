@@ -0,0 +1,80 @@
+// TestBitUnpack.cpp
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "TestCommon.h"
+#include "BitUnpack.h"
+
+namespace {
+    // 按存档格式打包:每个 long 从低位存放 64/bits 个条目,条目不跨 long,字节为大端
+    std::vector<char> Pack(const std::vector<uint32_t>& values, int bits) {
+        const size_t perLong = 64 / bits;
+        const size_t numLongs = (values.size() + perLong - 1) / perLong;
+        std::vector<char> data(numLongs * 8);
+        for (size_t l = 0; l < numLongs; ++l) {
+            uint64_t v = 0;
+            for (size_t k = 0; k < perLong && l * perLong + k < values.size(); ++k) {
+                v |= uint64_t(values[l * perLong + k]) << (k * bits);
+            }
+            for (int b = 0; b < 8; ++b) {
+                data[l * 8 + b] = static_cast<char>(v >> (56 - b * 8));
+            }
+        }
+        return data;
+    }
+}
+
+void TestBitUnpack() {
+    std::mt19937 rng(12345);
+
+    // 每种位宽,条目数分别为整 long 与带尾部
+    for (int bits = 1; bits <= 20; ++bits) {
+        for (size_t count : { size_t(4096), size_t(37) }) {
+            std::vector<uint32_t> values(count);
+            for (auto& value : values) {
+                value = rng() & ((1u << bits) - 1);
+            }
+            std::vector<char> data = Pack(values, bits);
+
+            std::vector<uint32_t> out(count, 0xFFFFFFFF);
+            size_t written = BitUnpack::Unpack(std::span<const char>(data), bits, count, out.data());
+            CHECK(written == count);
+            CHECK(out == values);
+        }
+    }
+
+    // 查找表映射
+    {
+        std::vector<uint32_t> values = { 0, 1, 2, 3, 15, 14, 7 };
+        std::vector<char> data = Pack(values, 4);
+        std::vector<uint16_t> table(16);
+        for (size_t i = 0; i < table.size(); ++i) {
+            table[i] = static_cast<uint16_t>(1000 + i);
+        }
+        std::vector<uint16_t> out(values.size());
+        BitUnpack::Unpack(std::span<const char>(data), 4, out.size(), out.data(), BitUnpack::Lut<uint16_t>{ table.data() });
+        for (size_t i = 0; i < values.size(); ++i) {
+            CHECK(out[i] == 1000 + values[i]);
+        }
+    }
+
+    // 数据不足时只写入已有的条目
+    {
+        std::vector<uint32_t> values(16, 5);
+        std::vector<char> data = Pack(values, 4);
+        std::vector<uint32_t> out(4096, 0);
+        CHECK(BitUnpack::Unpack(std::span<const char>(data), 4, out.size(), out.data()) == 16);
+        CHECK(out[15] == 5);
+        CHECK(out[16] == 0);
+        CHECK(BitUnpack::Unpack(std::span<const char>(data), 0, out.size(), out.data()) == 0);
+    }
+
+    // 位宽计算
+    CHECK(BitUnpack::CeilLog2(1) == 0);
+    CHECK(BitUnpack::CeilLog2(5) == 3);
+    CHECK(BitUnpack::CeilLog2(16) == 4);
+    CHECK(BitUnpack::BlockStateBits(2) == 4);
+    CHECK(BitUnpack::BlockStateBits(17) == 5);
+    CHECK(BitUnpack::BiomeBits(1) == 0);
+    CHECK(BitUnpack::BiomeBits(3) == 2);
+}
@@ -0,0 +1,26 @@
+// TestCommon.h
+#pragma once
+
+#include <iostream>
+
+// 失败的检查数,测试结束时非零即返回失败
+inline int& TestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+// 检查失败时输出位置并计数,不中断当前测试
+#define CHECK(expr)                                                                              \
+    do {                                                                                         \
+        if (!(expr)) {                                                                           \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": 检查失败: " << #expr << std::endl;    \
+            ++TestFailures();                                                                    \
+        }                                                                                        \
+    } while (0)
+
+// 各测试入口,定义在同名的 Test*.cpp 中
+void TestBitUnpack();
+void TestDecompressor();
+void TestFluidKey();
+void TestNbtArena();
+void TestSectionGrid();
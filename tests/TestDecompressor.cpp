@@ -0,0 +1,111 @@
+// TestDecompressor.cpp
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "TestCommon.h"
+#include "decompressor.h"
+
+namespace {
+    void AppendLE32(std::vector<char>& out, uint32_t value) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>(value >> (i * 8)));
+        }
+    }
+
+    // lz4-java LZ4BlockOutputStream 的块头;校验值解压时不检查
+    void AppendLZ4Block(std::vector<char>& out, unsigned method, const std::vector<unsigned char>& block, uint32_t originalLength) {
+        out.insert(out.end(), { 'L', 'Z', '4', 'B', 'l', 'o', 'c', 'k' });
+        out.push_back(static_cast<char>(method | 0x06));
+        AppendLE32(out, static_cast<uint32_t>(block.size()));
+        AppendLE32(out, originalLength);
+        AppendLE32(out, 0);
+        out.insert(out.end(), block.begin(), block.end());
+    }
+
+    std::string ToString(const ByteBuffer& buffer) {
+        return std::string(buffer.data(), buffer.size());
+    }
+
+    constexpr uint8_t kZlib = static_cast<uint8_t>(ChunkCompression::Zlib);
+    constexpr uint8_t kLZ4 = static_cast<uint8_t>(ChunkCompression::LZ4);
+}
+
+void TestDecompressor() {
+    // 手工构造的 LZ4 原始块:字面量 "abc" + 偏移 3 的重叠匹配(长 20),最后一个序列只有字面量 "XYZ"
+    const std::vector<unsigned char> overlapBlock = { 0x3F, 'a', 'b', 'c', 0x03, 0x00, 0x01, 0x30, 'X', 'Y', 'Z' };
+    const std::string overlapText = "abcabcabcabcabcabcabcabXYZ";
+
+    // 300 字节的字面量,长度使用扩展字节(15 + 255 + 30)
+    std::string longText(300, '\0');
+    for (size_t i = 0; i < longText.size(); ++i) {
+        longText[i] = static_cast<char>('a' + i % 26);
+    }
+    std::vector<unsigned char> literalBlock = { 0xF0, 0xFF, 0x1E };
+    literalBlock.insert(literalBlock.end(), longText.begin(), longText.end());
+
+    const std::string rawText = "raw block";
+    const std::vector<unsigned char> rawBlock(rawText.begin(), rawText.end());
+
+    // 多个块依次拼接,以长度为 0 的结束块收尾
+    {
+        std::vector<char> stream;
+        AppendLZ4Block(stream, 0x20, overlapBlock, static_cast<uint32_t>(overlapText.size()));
+        AppendLZ4Block(stream, 0x20, literalBlock, static_cast<uint32_t>(longText.size()));
+        AppendLZ4Block(stream, 0x10, rawBlock, static_cast<uint32_t>(rawBlock.size()));
+        AppendLZ4Block(stream, 0x10, {}, 0);
+
+        ByteBuffer output;
+        CHECK(DecompressChunk(std::span<const char>(stream), kLZ4, output));
+        CHECK(ToString(output) == overlapText + longText + rawText);
+    }
+
+    // 没有结束块、数据恰好用尽时同样成功
+    {
+        std::vector<char> stream;
+        AppendLZ4Block(stream, 0x20, overlapBlock, static_cast<uint32_t>(overlapText.size()));
+        ByteBuffer output;
+        CHECK(DecompressChunk(std::span<const char>(stream), kLZ4, output));
+        CHECK(ToString(output) == overlapText);
+    }
+
+    // 匹配偏移超出已解压数据、原始长度与解码结果不符、数据被截断都应失败
+    {
+        std::vector<unsigned char> badOffset = overlapBlock;
+        badOffset[4] = 0x04;
+        std::vector<char> stream;
+        AppendLZ4Block(stream, 0x20, badOffset, static_cast<uint32_t>(overlapText.size()));
+        ByteBuffer output;
+        CHECK(!DecompressChunk(std::span<const char>(stream), kLZ4, output));
+
+        stream.clear();
+        AppendLZ4Block(stream, 0x20, overlapBlock, static_cast<uint32_t>(overlapText.size()) + 1);
+        CHECK(!DecompressChunk(std::span<const char>(stream), kLZ4, output));
+
+        stream.clear();
+        AppendLZ4Block(stream, 0x20, overlapBlock, static_cast<uint32_t>(overlapText.size()));
+        stream.pop_back();
+        CHECK(!DecompressChunk(std::span<const char>(stream), kLZ4, output));
+    }
+
+    // zlib:复用同一个缓冲区,先解压大数据再解压小数据
+    {
+        std::string large(200000, '\0');
+        for (size_t i = 0; i < large.size(); ++i) {
+            large[i] = static_cast<char>((i * 7) % 251);
+        }
+        const std::string small = "small chunk";
+
+        ByteBuffer output;
+        for (const std::string& text : { large, small }) {
+            uLongf compressedSize = compressBound(static_cast<uLong>(text.size()));
+            std::vector<char> compressed(compressedSize);
+            CHECK(compress(reinterpret_cast<Bytef*>(compressed.data()), &compressedSize,
+                reinterpret_cast<const Bytef*>(text.data()), static_cast<uLong>(text.size())) == Z_OK);
+            compressed.resize(compressedSize);
+
+            CHECK(DecompressChunk(std::span<const char>(compressed), kZlib, output));
+            CHECK(ToString(output) == text);
+        }
+    }
+}
@@ -0,0 +1,51 @@
+// TestFluidKey.cpp
+#include <array>
+#include <cstdint>
+#include <unordered_set>
+#include "TestCommon.h"
+#include "BlockTraits.h"
+#include "fluid.h"
+
+void TestFluidKey() {
+    const std::array<int, 10> still = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    // 有效键最高位为 1,0 表示无法打包
+    const uint64_t key = FluidModelCache::PackKey(still, 0);
+    CHECK(key != 0);
+    CHECK((key >> 63) == 1);
+    CHECK(FluidModelCache::PackKey(still, 0) == key);
+
+    // 液位取值范围 -2..29
+    std::array<int, 10> levels = still;
+    levels[3] = -2;
+    CHECK(FluidModelCache::PackKey(levels, 0) != 0);
+    levels[3] = 29;
+    CHECK(FluidModelCache::PackKey(levels, 0) != 0);
+    levels[3] = 30;
+    CHECK(FluidModelCache::PackKey(levels, 0) == 0);
+    levels[3] = -3;
+    CHECK(FluidModelCache::PackKey(levels, 0) == 0);
+
+    // 没有流体编号与编号 0 不能相同;超出 13 位的编号无法打包
+    CHECK(FluidModelCache::PackKey(still, BlockTraitsTable::kNoFluid) != 0);
+    CHECK(FluidModelCache::PackKey(still, BlockTraitsTable::kNoFluid) != key);
+    CHECK(FluidModelCache::PackKey(still, 8190) != 0);
+    CHECK(FluidModelCache::PackKey(still, 8191) == 0);
+
+    // 每个位置、每个液位、每个流体编号都得到不同的键
+    std::unordered_set<uint64_t> keys;
+    size_t total = 0;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        for (int level = -2; level <= 29; ++level) {
+            for (uint16_t fluidId : { uint16_t(0), uint16_t(1), BlockTraitsTable::kNoFluid }) {
+                std::array<int, 10> neighbors = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+                neighbors[i] = level;
+                keys.insert(FluidModelCache::PackKey(neighbors, fluidId));
+                ++total;
+            }
+        }
+    }
+    // 各位置取 1 时的键在每个位置都出现一次,去重后少 levels.size() - 1 组
+    CHECK(keys.size() == total - (levels.size() - 1) * 3);
+    CHECK(keys.count(0) == 0);
+}
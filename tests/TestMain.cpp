@@ -0,0 +1,38 @@
+// TestMain.cpp
+// 用法: WorldImporterTests [测试名],不带参数时运行全部测试
+#include <cstring>
+#include <iostream>
+#include "TestCommon.h"
+
+namespace {
+    struct TestEntry {
+        const char* name;
+        void (*run)();
+    };
+
+    const TestEntry kTests[] = {
+        { "BitUnpack", TestBitUnpack },
+        { "Decompressor", TestDecompressor },
+        { "FluidKey", TestFluidKey },
+        { "NbtArena", TestNbtArena },
+        { "SectionGrid", TestSectionGrid },
+    };
+}
+
+int main(int argc, char** argv) {
+    bool found = false;
+    for (const TestEntry& test : kTests) {
+        if (argc > 1 && std::strcmp(argv[1], test.name) != 0) {
+            continue;
+        }
+        found = true;
+        const int before = TestFailures();
+        test.run();
+        std::cout << test.name << ": " << (TestFailures() == before ? "通过" : "失败") << std::endl;
+    }
+    if (!found) {
+        std::cerr << "错误: 未知的测试: " << argv[1] << std::endl;
+        return 1;
+    }
+    return TestFailures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+// TestNbtArena.cpp
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestCommon.h"
+#include "nbtutils.h"
+
+namespace {
+    // 按 NBT 格式(大端)构造测试数据
+    struct NbtWriter {
+        std::vector<char> data;
+
+        void Byte(uint8_t value) { data.push_back(static_cast<char>(value)); }
+        void Short(uint16_t value) { Byte(value >> 8); Byte(value & 0xFF); }
+        void Int(uint32_t value) { Short(value >> 16); Short(value & 0xFFFF); }
+        void Long(uint64_t value) { Int(static_cast<uint32_t>(value >> 32)); Int(static_cast<uint32_t>(value)); }
+        void String(const std::string& value) {
+            Short(static_cast<uint16_t>(value.size()));
+            data.insert(data.end(), value.begin(), value.end());
+        }
+        void Tag(TagType type, const std::string& name) {
+            Byte(static_cast<uint8_t>(type));
+            String(name);
+        }
+        void End() { Byte(0); }
+    };
+
+    // 根复合标签:
+    // { b: 5b, i: 0x01020304, s: "hi", l: [1, 2, 3], c: { x: 7L, skip: [I; 9, 9] }, la: [L; 1, 2] }
+    std::vector<char> BuildSample() {
+        NbtWriter w;
+        w.Tag(TagType::COMPOUND, "");
+        w.Tag(TagType::BYTE, "b");
+        w.Byte(5);
+        w.Tag(TagType::INT, "i");
+        w.Int(0x01020304);
+        w.Tag(TagType::STRING, "s");
+        w.String("hi");
+        w.Tag(TagType::LIST, "l");
+        w.Byte(static_cast<uint8_t>(TagType::INT));
+        w.Int(3);
+        w.Int(1);
+        w.Int(2);
+        w.Int(3);
+        w.Tag(TagType::COMPOUND, "c");
+        w.Tag(TagType::LONG, "x");
+        w.Long(7);
+        w.Tag(TagType::INT_ARRAY, "skip");
+        w.Int(2);
+        w.Int(9);
+        w.Int(9);
+        w.End();
+        w.Tag(TagType::LONG_ARRAY, "la");
+        w.Int(2);
+        w.Long(1);
+        w.Long(2);
+        w.End();
+        return w.data;
+    }
+}
+
+void TestNbtArena() {
+    const std::vector<char> sample = BuildSample();
+    const std::span<const char> data(sample);
+    NbtArena arena;
+
+    // 完整解析:节点指向原缓冲区,不复制负载
+    size_t index = 0;
+    const NbtNode* root = readTag(data, index, arena);
+    CHECK(index == sample.size());
+    CHECK(root && root->type == TagType::COMPOUND);
+    CHECK(root && root->childCount == 6);
+
+    const NbtNode* byteTag = getChildByName(root, "b");
+    CHECK(byteTag && byteTag->type == TagType::BYTE && byteTag->payload[0] == 5);
+    const NbtNode* intTag = getChildByName(root, "i");
+    CHECK(intTag && bytesToInt(intTag->payload) == 0x01020304);
+    CHECK(intTag && intTag->payload.data() >= sample.data() && intTag->payload.data() < sample.data() + sample.size());
+    CHECK(getStringView(getChildByName(root, "s")) == "hi");
+
+    const NbtNode* list = getChildByName(root, "l");
+    CHECK(list && list->type == TagType::LIST && list->listType == TagType::INT && list->childCount == 3);
+    if (list) {
+        int expected = 1;
+        for (const NbtNode* element : list->children()) {
+            CHECK(element->name.empty());
+            CHECK(bytesToInt(element->payload) == expected);
+            ++expected;
+        }
+        CHECK(expected == 4);
+    }
+
+    const NbtNode* compound = getChildByName(root, "c");
+    CHECK(compound && compound->childCount == 2);
+    const NbtNode* longTag = getChildByName(compound, "x");
+    CHECK(longTag && bytesToLong(longTag->payload) == 7);
+
+    const NbtNode* longArray = getChildByName(root, "la");
+    CHECK(longArray && longArray->payload.size() == 16);
+    CHECK(longArray && bytesToLong(longArray->payload.subspan(8, 8)) == 2);
+    CHECK(getChildByName(root, "missing") == nullptr);
+
+    // Reset 后复用同一批节点
+    arena.Reset();
+    index = 0;
+    CHECK(readTag(data, index, arena) == root);
+
+    // 按模式解析:模式之外的子树被跳过,但读取位置照常前进
+    {
+        NbtSchema schema{ "c/x", "s" };
+        arena.Reset();
+        index = 0;
+        const NbtNode* partial = readTag(data, index, arena, schema);
+        CHECK(index == sample.size());
+        CHECK(partial && partial->childCount == 2);
+        CHECK(getChildByName(partial, "b") == nullptr);
+        CHECK(getChildByName(partial, "l") == nullptr);
+        CHECK(getStringView(getChildByName(partial, "s")) == "hi");
+        const NbtNode* partialCompound = getChildByName(partial, "c");
+        CHECK(partialCompound && partialCompound->childCount == 1);
+        CHECK(getChildByName(partialCompound, "x") != nullptr);
+        CHECK(getChildByName(partialCompound, "skip") == nullptr);
+    }
+
+    // 截断的数据抛出 std::out_of_range
+    for (size_t length : { size_t(0), size_t(5), sample.size() / 2, sample.size() - 1 }) {
+        arena.Reset();
+        index = 0;
+        bool threw = false;
+        try {
+            readTag(data.first(length), index, arena);
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+}
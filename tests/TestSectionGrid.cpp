@@ -0,0 +1,94 @@
+// TestSectionGrid.cpp
+#include <memory>
+#include "TestCommon.h"
+#include "EpochManager.h"
+#include "SectionGrid.h"
+
+namespace {
+    std::unique_ptr<ChunkColumn> MakeColumn(int minSectionY, size_t sectionCount, uint16_t block) {
+        auto column = std::make_unique<ChunkColumn>();
+        column->minSectionY = minSectionY;
+        column->sections.resize(sectionCount);
+        for (SectionCacheEntry& section : column->sections) {
+            section.uniformBlock = block;
+        }
+        return column;
+    }
+}
+
+void TestSectionGrid() {
+    // 读作用域内移除的区块和旧窗口只登记,离开作用域后才能回收
+    {
+        EpochGuard guard;
+
+        // ChunkColumn 按 sectionY - minSectionY 取子区块,范围外返回 nullptr
+        {
+            auto column = MakeColumn(-4, 24, 7);
+            CHECK(column->GetSection(-4) == &column->sections[0]);
+            CHECK(column->GetSection(19) == &column->sections[23]);
+            CHECK(column->GetSection(-5) == nullptr);
+            CHECK(column->GetSection(20) == nullptr);
+        }
+
+        // 非均匀子区块按 YZX 下标读取
+        {
+            SectionCacheEntry section;
+            CHECK(section.IsUniform());
+            section.blockData.assign(4096, 1);
+            section.blockData[(15 * 16 + 2) * 16 + 3] = 9;
+            CHECK(!section.IsUniform());
+            CHECK(section.GetBlock((15 * 16 + 2) * 16 + 3) == 9);
+            CHECK(section.GetBlock(0) == 1);
+            section.uniformBiome = 4;
+            CHECK(section.GetBiome(63) == 4);
+        }
+
+        SectionGrid grid;
+        grid.SetWindow(-2, 1, 10, 12);
+
+        // 窗口内外(包括负坐标与窗口边界)都能查到,未加载的区块返回 nullptr
+        grid.Insert(-2, 10, MakeColumn(-4, 24, 1));
+        grid.Insert(1, 12, MakeColumn(-4, 24, 2));
+        grid.Insert(-3, 10, MakeColumn(0, 16, 3));
+        grid.Insert(100, -100, MakeColumn(0, 16, 4));
+        CHECK(grid.ColumnCount() == 4);
+
+        CHECK(grid.FindSection(-2, -4, 10) && grid.FindSection(-2, -4, 10)->GetBlock(0) == 1);
+        CHECK(grid.FindSection(1, 19, 12) && grid.FindSection(1, 19, 12)->GetBlock(0) == 2);
+        CHECK(grid.FindSection(-3, 0, 10) && grid.FindSection(-3, 0, 10)->GetBlock(0) == 3);
+        CHECK(grid.FindSection(100, 15, -100) && grid.FindSection(100, 15, -100)->GetBlock(0) == 4);
+        CHECK(grid.FindSection(-3, -1, 10) == nullptr);
+        CHECK(grid.FindSection(1, 20, 12) == nullptr);
+        CHECK(!grid.HasColumn(0, 11));
+        CHECK(!grid.HasColumn(2, 10));
+
+        // 窗口滑动后已加载的区块仍可查到
+        grid.SetWindow(-3, -3, 9, 10);
+        CHECK(grid.HasColumn(-3, 10));
+        CHECK(grid.HasColumn(-2, 10));
+        CHECK(grid.HasColumn(1, 12));
+
+        // 替换与移除
+        grid.Insert(-3, 10, MakeColumn(0, 16, 5));
+        CHECK(grid.FindSection(-3, 0, 10)->GetBlock(0) == 5);
+        CHECK(grid.ColumnCount() == 4);
+        grid.Erase(-3, 10);
+        grid.Erase(1, 12);
+        CHECK(!grid.HasColumn(-3, 10));
+        CHECK(!grid.HasColumn(1, 12));
+        CHECK(grid.ColumnCount() == 2);
+
+        // 加载去重:首次由调用方加载,发布后不再重复加载
+        CHECK(grid.BeginLoad(5, 5));
+        grid.PublishColumn(5, 5, MakeColumn(0, 1, 6));
+        CHECK(!grid.BeginLoad(5, 5));
+        CHECK(grid.FindSection(5, 0, 5)->GetBlock(0) == 6);
+
+        grid.Clear();
+        CHECK(grid.ColumnCount() == 0);
+        CHECK(!grid.HasColumn(-2, 10));
+    }
+
+    EpochManager::GetInstance().Reclaim();
+    CHECK(EpochManager::GetInstance().GetPendingCount() == 0);
+}